@@ -0,0 +1,105 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#ifndef NDEBUG
+#define METRO_TRACK_ALLOCATIONS 1
+#endif
+
+namespace {
+    thread_local std::size_t tAllocations = 0;
+    thread_local int tExemptDepth = 0;
+    std::atomic<std::size_t> gViolations{ 0 };
+
+    // A scope that allocates every frame would otherwise fill the log
+    bool shouldReport(std::size_t violation) {
+        return violation < 8 || violation % 1024 == 0;
+    }
+}
+
+#ifdef METRO_TRACK_ALLOCATIONS
+
+namespace {
+    void* countedAlloc(std::size_t size) {
+        if (tExemptDepth == 0) {
+            ++tAllocations;
+        }
+        if (size == 0) {
+            size = 1;
+        }
+        void* p = std::malloc(size);
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlloc(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlloc(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif
+
+namespace AllocationTracker {
+    bool isEnabled() {
+#ifdef METRO_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    std::size_t getThreadCount() { return tAllocations; }
+
+    std::size_t getViolationCount() { return gViolations.load(std::memory_order_relaxed); }
+
+    Exemption::Exemption() { ++tExemptDepth; }
+    Exemption::~Exemption() { --tExemptDepth; }
+
+    Guard::Guard(const char* scope, bool enforce)
+        : mScope(scope), mEnforce(enforce), mStart(tAllocations) {
+    }
+
+    Guard::~Guard() {
+        std::size_t count = getCount();
+        if (!mEnforce || count == 0) {
+            return;
+        }
+        const std::size_t violation = gViolations.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (shouldReport(violation)) {
+            Exemption logging;
+            std::cerr << "AllocationTracker: " << count << " heap allocation(s) inside " << mScope
+                << " after warm-up (violation " << violation << ")" << std::endl;
+        }
+#ifdef METRO_ENFORCE_ALLOCATIONS
+        assert(count == 0 && "heap allocation inside a guarded frame scope");
+#endif
+    }
+
+    std::size_t Guard::getCount() const { return tAllocations - mStart; }
+}
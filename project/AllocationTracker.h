@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+
+// Debug-build heap allocation counter. AllocationTracker.cpp replaces the
+// global operator new and counts calls per thread, so SFML's audio thread
+// does not show up in the game thread's numbers. Release builds (NDEBUG)
+// compile it all out and isEnabled() returns false.
+//
+// A guarded scope that allocates is reported on stderr. Only builds with
+// METRO_ENFORCE_ALLOCATIONS defined (`make debug`, the Visual Studio Debug
+// configurations) stop on it with an assert.
+namespace AllocationTracker {
+    bool isEnabled();
+
+    // Number of heap allocations made by the calling thread so far.
+    std::size_t getThreadCount();
+
+    // Guarded scopes that allocated after warm-up, on any thread.
+    std::size_t getViolationCount();
+
+    // Allocations made while an Exemption is alive are not counted. Keep these
+    // to hand-offs into third-party code that owns its own copy.
+    class Exemption {
+    public:
+        Exemption();
+        ~Exemption();
+        Exemption(const Exemption&) = delete;
+        Exemption& operator=(const Exemption&) = delete;
+    };
+
+    // Counts allocations over a scope. When 'enforce' is set (the caller is
+    // past warm-up) a non-zero count is a violation: reported naming the
+    // scope, or an assert failure where allocations are enforced.
+    class Guard {
+    public:
+        Guard(const char* scope, bool enforce);
+        ~Guard();
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        std::size_t getCount() const;
+
+    private:
+        const char* mScope;
+        bool mEnforce;
+        std::size_t mStart;
+    };
+}
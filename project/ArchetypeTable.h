@@ -0,0 +1,110 @@
+#pragma once
+#include "Snapshot.h"
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+// Dense storage for one archetype: every entity in the table has exactly the
+// same set of components, and each component type gets its own contiguous
+// column. Row i of every column belongs to the same entity, so a system that
+// only needs Position and Velocity walks two flat arrays and nothing else.
+template <typename... Components> class ArchetypeTable {
+public:
+    static_assert(sizeof...(Components) > 0, "ArchetypeTable needs at least one component");
+
+    size_t size() const { return std::get<0>(mColumns).size(); }
+    bool empty() const { return size() == 0; }
+
+    void reserve(size_t capacity) {
+        (std::get<std::vector<Components>>(mColumns).reserve(capacity), ...);
+    }
+
+    size_t capacity() const { return std::get<0>(mColumns).capacity(); }
+
+    // Appends a row and returns its index.
+    size_t add(const Components&... values) {
+        (std::get<std::vector<Components>>(mColumns).push_back(values), ...);
+        return size() - 1;
+    }
+
+    template <typename C> C* column() { return std::get<std::vector<C>>(mColumns).data(); }
+    template <typename C> const C* column() const { return std::get<std::vector<C>>(mColumns).data(); }
+
+    template <typename C> C& get(size_t row) { return std::get<std::vector<C>>(mColumns)[row]; }
+    template <typename C> const C& get(size_t row) const { return std::get<std::vector<C>>(mColumns)[row]; }
+
+    // Stable in-place removal: keeps rows for which keep(row) is true and
+    // preserves their relative order (entities stay sorted by spawn time).
+    template <typename Keep> void compact(Keep keep) {
+        const size_t count = size();
+        size_t writeIdx = 0;
+        for (size_t readIdx = 0; readIdx < count; ++readIdx) {
+            if (!keep(readIdx)) {
+                continue;
+            }
+            if (writeIdx != readIdx) {
+                moveRow(readIdx, writeIdx);
+            }
+            writeIdx++;
+        }
+        (std::get<std::vector<Components>>(mColumns).resize(writeIdx), ...);
+    }
+
+    // O(1)-per-row removal that fills each hole with the last row. Cheaper
+    // than compact() when row order does not matter.
+    template <typename Remove> void removeUnordered(Remove remove) {
+        removeUnordered(remove, [](size_t) {}, [](size_t, size_t) {});
+    }
+
+    // Same, calling onRemove(row) before a row is dropped and
+    // onMove(from, to) after a row has been moved into a hole.
+    template <typename Remove, typename OnRemove, typename OnMove>
+    void removeUnordered(Remove remove, OnRemove onRemove, OnMove onMove) {
+        size_t count = size();
+        size_t row = 0;
+        while (row < count) {
+            if (remove(row)) {
+                onRemove(row);
+                --count;
+                if (row != count) {
+                    moveRow(count, row);
+                    onMove(count, row);
+                }
+                continue; // re-test the row that was moved in
+            }
+            ++row;
+        }
+        (std::get<std::vector<Components>>(mColumns).resize(count), ...);
+    }
+
+    // Removes one row by moving the last row into it. If row < size()
+    // afterwards, the row now holds what used to be the last row.
+    void removeRowUnordered(size_t row) {
+        const size_t last = size() - 1;
+        if (row != last) {
+            moveRow(last, row);
+        }
+        (std::get<std::vector<Components>>(mColumns).pop_back(), ...);
+    }
+
+    void clear() {
+        (std::get<std::vector<Components>>(mColumns).clear(), ...);
+    }
+
+    // Every column as raw rows. Components are plain data.
+    void saveState(SnapshotWriter& writer) const {
+        (writer.values(std::get<std::vector<Components>>(mColumns)), ...);
+    }
+
+    bool loadState(SnapshotReader& reader) {
+        const bool ok = (reader.values(std::get<std::vector<Components>>(mColumns)) && ...);
+        return ok && ((std::get<std::vector<Components>>(mColumns).size() == size()) && ...);
+    }
+
+private:
+    void moveRow(size_t from, size_t to) {
+        ((std::get<std::vector<Components>>(mColumns)[to] = std::get<std::vector<Components>>(mColumns)[from]), ...);
+    }
+
+    std::tuple<std::vector<Components>...> mColumns;
+};
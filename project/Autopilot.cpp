@@ -0,0 +1,158 @@
+#include "Autopilot.h"
+#include "LaneSystem.h"
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+
+namespace {
+    const PlayerAction kActions[] = {
+        PlayerAction::MOVE_LEFT, PlayerAction::MOVE_RIGHT, PlayerAction::JUMP, PlayerAction::SLIDE
+    };
+    // Delays before a plan's second action; a lane change takes about 0.2 s
+    const float kFollowUpDelays[] = { 0.15f, 0.3f, 0.5f };
+
+    SimulationConfig scratchConfig() {
+        SimulationConfig config;
+        config.seed = 0;
+        config.loadStoredScores = false;
+        return config;
+    }
+
+    // Whether 'action' could change anything right now.
+    bool canPerform(const Player& player, PlayerAction action) {
+        switch (action) {
+        case PlayerAction::MOVE_LEFT: return player.getLane() > 0;
+        case PlayerAction::MOVE_RIGHT: return player.getLane() < LaneSystem::LANE_COUNT - 1;
+        case PlayerAction::JUMP: return player.getState() != PlayerState::JUMPING;
+        case PlayerAction::SLIDE: return player.getState() != PlayerState::SLIDING;
+        }
+        return false;
+    }
+}
+
+Autopilot::Autopilot(const AutopilotConfig& config)
+    : mConfig(config), mOrigin(scratchConfig()), mScratch(scratchConfig()) {
+}
+
+bool Autopilot::decide(const Simulation& simulation, PlayerAction& action) {
+    if (simulation.isOver()) {
+        return false;
+    }
+    sf::Clock clock;
+    const std::uint64_t now = simulation.getTickCount();
+    if (now != mNextTick || simulation.getReplay().getEventCount() != mExpectedEvents) {
+        // A new run, a rewind, a skipped tick or a key press: the plan no
+        // longer describes what will happen
+        mPlan.count = 0;
+        mSafeUntil = 0;
+    }
+    const std::uint64_t horizon = std::max<std::uint64_t>(1,
+        static_cast<std::uint64_t>(mConfig.horizonSeconds / simulation.getTickTime().asSeconds()));
+    if (now + horizon / 2 >= mSafeUntil) {
+        search(simulation, horizon);
+    }
+    else {
+        mLastSearchSteps = 0;
+    }
+
+    // Plans never hold two actions for the same tick
+    const bool press = mPlan.count > 0 && mPlan.actions[0].tick <= now;
+    if (press) {
+        action = mPlan.actions[0].action;
+        mPlan.actions[0] = mPlan.actions[1];
+        mPlan.count--;
+    }
+    mNextTick = now + 1;
+    mExpectedEvents = simulation.getReplay().getEventCount() + (press ? 1 : 0);
+    mLastSearchMicros = clock.getElapsedTime().asMicroseconds();
+    mMaxSearchMicros = std::max(mMaxSearchMicros, mLastSearchMicros);
+    return press;
+}
+
+void Autopilot::play(Simulation& simulation) {
+    PlayerAction action;
+    if (decide(simulation, action)) {
+        simulation.perform(action);
+    }
+}
+
+void Autopilot::search(const Simulation& simulation, std::uint64_t horizon) {
+    sf::Clock clock;
+    mOrigin.cloneFrom(simulation);
+    std::size_t budget = mConfig.stepBudget;
+    const std::uint64_t now = simulation.getTickCount();
+    std::uint64_t bestTicks = playOut(mPlan, horizon, budget);
+    if (bestTicks >= horizon) {
+        mSafeUntil = now + horizon;
+        mLastSearchSteps = mConfig.stepBudget - budget;
+        return;
+    }
+
+    // Single actions (and doing nothing) first, then pairs: the first plan
+    // that survives wins, so the bot never presses more than it needs to
+    const float tickSeconds = simulation.getTickTime().asSeconds();
+    const Player& player = simulation.getPlayer();
+    Plan best = mPlan;
+    auto consider = [&](const Plan& plan) {
+        const std::uint64_t ticks = playOut(plan, horizon, budget);
+        if (ticks > bestTicks) {
+            bestTicks = ticks;
+            best = plan;
+        }
+        const bool outOfTime = mConfig.timeBudgetMicros > 0 &&
+            clock.getElapsedTime().asMicroseconds() >= mConfig.timeBudgetMicros;
+        return bestTicks >= horizon || budget == 0 || outOfTime;
+    };
+
+    bool done = mPlan.count > 0 && consider(Plan());
+    for (PlayerAction first : kActions) {
+        if (done) {
+            break;
+        }
+        if (canPerform(player, first)) {
+            Plan plan;
+            plan.actions[plan.count++] = PlannedAction{ now, first };
+            done = consider(plan);
+        }
+    }
+    for (float delay : kFollowUpDelays) {
+        const std::uint64_t later = now + std::max<std::uint64_t>(1, static_cast<std::uint64_t>(delay / tickSeconds));
+        for (int first = -1; first < 4 && !done; ++first) {
+            if (first >= 0 && !canPerform(player, kActions[first])) {
+                continue;
+            }
+            for (PlayerAction second : kActions) {
+                Plan plan;
+                if (first >= 0) {
+                    plan.actions[plan.count++] = PlannedAction{ now, kActions[first] };
+                }
+                plan.actions[plan.count++] = PlannedAction{ later, second };
+                if ((done = consider(plan))) {
+                    break;
+                }
+            }
+        }
+    }
+
+    mPlan = best;
+    mSafeUntil = bestTicks >= horizon ? now + horizon : 0;
+    mDoomed += bestTicks < horizon;
+    mLastSearchSteps = mConfig.stepBudget - budget;
+}
+
+std::uint64_t Autopilot::playOut(const Plan& plan, std::uint64_t horizon, std::size_t& budget) {
+    mScratch.cloneFrom(mOrigin);
+    const std::uint64_t start = mOrigin.getTickCount();
+    std::size_t next = 0;
+    while (mScratch.getTickCount() - start < horizon && budget > 0) {
+        while (next < plan.count && plan.actions[next].tick <= mScratch.getTickCount()) {
+            mScratch.perform(plan.actions[next++].action);
+        }
+        mScratch.step();
+        budget--;
+        if (mScratch.isOver()) {
+            // Ticks survived before the fatal one
+            return mScratch.getTickCount() - start - 1;
+        }
+    }
+    return mScratch.getTickCount() - start;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "Simulation.h"
+#include <SFML/System/Time.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+struct AutopilotConfig {
+    float horizonSeconds = 2.0f; // how far ahead each plan is played out
+    // Simulated ticks one decision may spend. Counted in ticks rather than
+    // time so batch runs with the bot stay reproducible. A tick costs about
+    // 0.2 us optimised and 1.5-2 us in an unoptimised build, so the default
+    // is up to about 1 ms or 8 ms.
+    std::size_t stepBudget = 4000;
+    // Wall-clock cap on one decision, checked between playouts; 0 for none.
+    // Makes the bot depend on machine speed, so only for interactive play.
+    sf::Int64 timeBudgetMicros = 0;
+};
+
+// Built-in player for soak tests and attract mode. When it searches, it
+// clones the run once (Simulation::cloneFrom) and plays candidate plans - up to two of
+// moveLeft, moveRight, jump and slide, the second after a short delay -
+// through the real collision rules for horizonSeconds, and follows the first
+// plan that survives. The run is deterministic, so a plan that survived a
+// playout is safe for as long as it was played out: it is only checked
+// again (and replaced if it no longer survives the full horizon) once half
+// of that is used up, or when someone else presses a key. Most ticks cost
+// nothing at all.
+//
+// The clone includes the spawn RNG, so the bot sees what will spawn: it is a
+// stress player, not a fair one.
+class Autopilot {
+public:
+    explicit Autopilot(const AutopilotConfig& config = AutopilotConfig());
+
+    // Decides what to press before the coming step. Returns false to press
+    // nothing; otherwise 'action' must be performed before the step. Call
+    // once per tick; skipping ticks drops the plan. Does not allocate once
+    // the scratch clone has grown to the run's size.
+    bool decide(const Simulation& simulation, PlayerAction& action);
+    // decide() and perform the action, if any.
+    void play(Simulation& simulation);
+
+    // Search cost, for the debug overlay and soak tests. Zero on ticks that
+    // did not need to search.
+    std::size_t getLastSearchSteps() const { return mLastSearchSteps; }
+    sf::Int64 getLastSearchMicros() const { return mLastSearchMicros; }
+    sf::Int64 getMaxSearchMicros() const { return mMaxSearchMicros; }
+    // Decisions where no plan survived the whole horizon.
+    std::uint64_t getDoomedCount() const { return mDoomed; }
+
+private:
+    struct PlannedAction {
+        std::uint64_t tick; // performed before this tick's step
+        PlayerAction action;
+    };
+    struct Plan {
+        std::array<PlannedAction, 2> actions{};
+        std::size_t count = 0;
+    };
+
+    // Plays 'plan' out on a copy of mOrigin; returns the ticks survived.
+    std::uint64_t playOut(const Plan& plan, std::uint64_t horizon, std::size_t& budget);
+    void search(const Simulation& simulation, std::uint64_t horizon);
+
+    AutopilotConfig mConfig;
+    // The run as the search found it, copied once so that a run generating
+    // its track on a worker is paused once per search, not per playout
+    Simulation mOrigin;
+    Simulation mScratch; // every playout runs on a copy of mOrigin
+    Plan mPlan;
+    std::uint64_t mNextTick = 0; // tick the plan expects play() at next
+    std::size_t mExpectedEvents = 0; // replay length if only the bot pressed keys
+    std::uint64_t mSafeUntil = 0; // the plan has been played out up to here
+
+    std::size_t mLastSearchSteps = 0;
+    sf::Int64 mLastSearchMicros = 0;
+    sf::Int64 mMaxSearchMicros = 0;
+    std::uint64_t mDoomed = 0;
+};
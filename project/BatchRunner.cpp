@@ -0,0 +1,160 @@
+#include "BatchRunner.h"
+#include "ConcreteObstacles.h"
+#include "Simulation.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace {
+    // SplitMix64 finaliser: spreads neighbouring run indices over the seed space.
+    std::uint64_t mixSeed(std::uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    RunResult playRun(const BatchConfig& config, std::size_t index) {
+        const std::uint64_t mixed = mixSeed(config.baseSeed + index);
+        SimulationConfig simulationConfig;
+        simulationConfig.seed = static_cast<unsigned int>(mixed);
+        simulationConfig.tickRate = config.tickRate;
+        simulationConfig.loadStoredScores = false;
+        simulationConfig.chunks = config.chunks;
+
+        Simulation simulation(simulationConfig);
+        std::mt19937 inputRng(static_cast<unsigned int>(mixed >> 32));
+        const std::uint64_t maxTicks = static_cast<std::uint64_t>(config.maxSeconds * config.tickRate);
+
+        while (!simulation.isOver() && simulation.getTickCount() < maxTicks) {
+            config.policy(simulation, inputRng);
+            simulation.step();
+        }
+
+        RunResult result;
+        result.seed = simulationConfig.seed;
+        result.survivalSeconds = simulation.getElapsedSeconds();
+        result.score = simulation.getScore().getScore();
+        result.coins = simulation.getScore().getCoins();
+        result.died = simulation.isOver();
+        result.cause = simulation.getLastCollision().cause;
+        return result;
+    }
+
+    struct Distribution {
+        double mean = 0.0;
+        double min = 0.0;
+        double p10 = 0.0;
+        double p50 = 0.0;
+        double p90 = 0.0;
+        double max = 0.0;
+    };
+
+    template <typename Field> Distribution describe(const std::vector<RunResult>& results, Field field) {
+        Distribution d;
+        if (results.empty()) {
+            return d;
+        }
+        std::vector<double> values;
+        values.reserve(results.size());
+        double sum = 0.0;
+        for (const RunResult& result : results) {
+            values.push_back(static_cast<double>(field(result)));
+            sum += values.back();
+        }
+        std::sort(values.begin(), values.end());
+        auto at = [&](double q) { return values[static_cast<std::size_t>(q * static_cast<double>(values.size() - 1))]; };
+        d.mean = sum / static_cast<double>(values.size());
+        d.min = values.front();
+        d.p10 = at(0.1);
+        d.p50 = at(0.5);
+        d.p90 = at(0.9);
+        d.max = values.back();
+        return d;
+    }
+
+    void writeCsv(std::ostream& out, const char* metric, const Distribution& d) {
+        out << metric << ",mean," << d.mean << "\n"
+            << metric << ",min," << d.min << "\n"
+            << metric << ",p10," << d.p10 << "\n"
+            << metric << ",p50," << d.p50 << "\n"
+            << metric << ",p90," << d.p90 << "\n"
+            << metric << ",max," << d.max << "\n";
+    }
+
+    void writeJson(std::ostream& out, const char* metric, const Distribution& d) {
+        out << "  \"" << metric << "\": {\"mean\": " << d.mean << ", \"min\": " << d.min << ", \"p10\": " << d.p10
+            << ", \"p50\": " << d.p50 << ", \"p90\": " << d.p90 << ", \"max\": " << d.max << "},\n";
+    }
+}
+
+std::vector<RunResult> runBatch(const BatchConfig& config) {
+    std::vector<RunResult> results(config.runs);
+    unsigned int threadCount = config.threads > 0 ? config.threads : std::thread::hardware_concurrency();
+    threadCount = std::max(1u, std::min(threadCount, static_cast<unsigned int>(std::max<std::size_t>(config.runs, 1))));
+
+    std::atomic<std::size_t> nextRun{ 0 };
+    auto worker = [&]() {
+        for (std::size_t index = nextRun++; index < config.runs; index = nextRun++) {
+            results[index] = playRun(config, index);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threadCount - 1);
+    for (unsigned int i = 1; i < threadCount; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    return results;
+}
+
+void writeBatchReport(const BatchConfig& config, const std::vector<RunResult>& results, BatchFormat format,
+    std::ostream& out) {
+    const Distribution survival = describe(results, [](const RunResult& r) { return r.survivalSeconds; });
+    const Distribution coins = describe(results, [](const RunResult& r) { return r.coins; });
+    const Distribution score = describe(results, [](const RunResult& r) { return r.score; });
+
+    std::size_t deaths[ObstacleRegistry::COUNT] = {};
+    std::size_t survived = 0;
+    for (const RunResult& result : results) {
+        if (result.died) {
+            deaths[static_cast<std::size_t>(result.cause)]++;
+        }
+        else {
+            survived++;
+        }
+    }
+
+    if (format == BatchFormat::CSV) {
+        out << "metric,statistic,value\n"
+            << "runs,count," << results.size() << "\n";
+        writeCsv(out, "survival_seconds", survival);
+        writeCsv(out, "coins", coins);
+        writeCsv(out, "score", score);
+        for (const ObstacleSpec& spec : ObstacleRegistry::SPECS) {
+            out << "death_cause," << spec.name << "," << deaths[static_cast<std::size_t>(spec.type)] << "\n";
+        }
+        out << "death_cause,none," << survived << "\n";
+        return;
+    }
+
+    out << "{\n"
+        << "  \"runs\": " << results.size() << ",\n"
+        << "  \"policy\": \"" << config.policyName << "\",\n"
+        << "  \"tick_rate\": " << config.tickRate << ",\n"
+        << "  \"base_seed\": " << config.baseSeed << ",\n"
+        << "  \"max_seconds\": " << config.maxSeconds << ",\n";
+    writeJson(out, "survival_seconds", survival);
+    writeJson(out, "coins", coins);
+    writeJson(out, "score", score);
+    out << "  \"death_causes\": {";
+    for (const ObstacleSpec& spec : ObstacleRegistry::SPECS) {
+        out << "\"" << spec.name << "\": " << deaths[static_cast<std::size_t>(spec.type)] << ", ";
+    }
+    out << "\"none\": " << survived << "}\n"
+        << "}\n";
+}
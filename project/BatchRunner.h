@@ -0,0 +1,40 @@
+#pragma once
+#include "InputPolicy.h"
+#include "Obstacle.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+struct BatchConfig {
+    std::size_t runs = 1000;
+    unsigned int threads = 0; // 0 = one per hardware thread
+    std::uint64_t baseSeed = 1;
+    unsigned int tickRate = 60;
+    float maxSeconds = 600.0f; // runs still alive after this long are cut off
+    InputPolicy policy = &randomInput;
+    const char* policyName = "random";
+    const ChunkLibrary* chunks = nullptr; // authored track chunks for every run
+};
+
+struct RunResult {
+    unsigned int seed;
+    float survivalSeconds;
+    float score;
+    int coins;
+    bool died; // false if the run hit maxSeconds
+    ObstacleType cause; // only meaningful when died
+};
+
+enum class BatchFormat { CSV, JSON };
+
+// Plays config.runs complete games spread over a pool of threads. Every run
+// owns its Simulation and input rng, seeded from baseSeed and its index, so
+// the only thing the threads share is the counter handing out run indices
+// and the results are the same whatever the thread count.
+std::vector<RunResult> runBatch(const BatchConfig& config);
+
+// Writes the distributions of survival time, coins and score and the death
+// counts per obstacle type. CSV is long form: metric,statistic,value.
+void writeBatchReport(const BatchConfig& config, const std::vector<RunResult>& results, BatchFormat format,
+    std::ostream& out);
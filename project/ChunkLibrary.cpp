@@ -0,0 +1,381 @@
+#include "ChunkLibrary.h"
+#include "LaneSystem.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+namespace {
+    const char kMagic[4] = { 'M', 'C', 'H', 'K' };
+    const float DEFAULT_SPACING = 120.0f;
+
+    std::uint64_t hashBytes(const std::uint8_t* data, std::size_t size) {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ data[i]) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    // What each grid character spawns; '.' is an empty cell
+    struct CellCode {
+        char symbol;
+        Archetype archetype;
+        std::uint8_t type;
+    };
+
+    const CellCode kCellCodes[] = {
+        { 'T', Archetype::OBSTACLE, static_cast<std::uint8_t>(ObstacleType::TRAIN) },
+        { 'B', Archetype::OBSTACLE, static_cast<std::uint8_t>(ObstacleType::BARRIER) },
+        { 'C', Archetype::OBSTACLE, static_cast<std::uint8_t>(ObstacleType::CONE) },
+        { 'F', Archetype::OBSTACLE, static_cast<std::uint8_t>(ObstacleType::FENCE) },
+        { 'o', Archetype::COIN, 0 },
+        { 'M', Archetype::POWER_UP, static_cast<std::uint8_t>(PowerUpType::MAGNET) },
+        { 'J', Archetype::POWER_UP, static_cast<std::uint8_t>(PowerUpType::JETPACK) },
+        { 'S', Archetype::POWER_UP, static_cast<std::uint8_t>(PowerUpType::SHIELD) },
+        { 'D', Archetype::POWER_UP, static_cast<std::uint8_t>(PowerUpType::DOUBLE_COIN) },
+    };
+
+    const CellCode* findCellCode(char symbol) {
+        for (const CellCode& code : kCellCodes) {
+            if (code.symbol == symbol) {
+                return &code;
+            }
+        }
+        return nullptr;
+    }
+
+    struct SourceChunk {
+        std::string name;
+        int band = 0;
+        double weight = 1.0;
+        float spacing = DEFAULT_SPACING;
+        std::vector<std::string> rows; // furthest row first, as drawn on screen
+    };
+
+    class ChunkParser {
+    public:
+        ChunkParser(const std::string& sourceName, std::ostream& log) : mSourceName(sourceName), mLog(log) {}
+
+        bool parse(std::istream& source, std::vector<SourceChunk>& chunks) {
+            std::string line;
+            bool open = false;
+            while (std::getline(source, line)) {
+                mLine++;
+                line = line.substr(0, line.find('#'));
+                std::istringstream words(line);
+                std::string keyword;
+                if (!(words >> keyword)) {
+                    continue;
+                }
+                if (keyword == "chunk") {
+                    if (open) {
+                        return fail("chunk '" + chunks.back().name + "' has no 'end'");
+                    }
+                    SourceChunk chunk;
+                    if (!(words >> chunk.name)) {
+                        return fail("chunk needs a name");
+                    }
+                    for (const SourceChunk& other : chunks) {
+                        if (other.name == chunk.name) {
+                            return fail("chunk '" + chunk.name + "' is defined twice");
+                        }
+                    }
+                    chunks.push_back(chunk);
+                    open = true;
+                }
+                else if (!open) {
+                    return fail("'" + keyword + "' outside a chunk");
+                }
+                else if (keyword == "band") {
+                    if (!(words >> chunks.back().band) || chunks.back().band < 0 ||
+                        chunks.back().band >= static_cast<int>(ChunkFormat::BAND_COUNT)) {
+                        return fail("band must be 0 to " + std::to_string(ChunkFormat::BAND_COUNT - 1));
+                    }
+                }
+                else if (keyword == "weight") {
+                    if (!(words >> chunks.back().weight) || !(chunks.back().weight > 0.0)) {
+                        return fail("weight must be a positive number");
+                    }
+                }
+                else if (keyword == "spacing") {
+                    if (!(words >> chunks.back().spacing) || !(chunks.back().spacing > 0.0f)) {
+                        return fail("spacing must be a positive number of pixels");
+                    }
+                }
+                else if (keyword == "end") {
+                    if (chunks.back().rows.empty()) {
+                        return fail("chunk '" + chunks.back().name + "' has no rows");
+                    }
+                    open = false;
+                }
+                else {
+                    if (!parseRow(line, chunks.back())) {
+                        return false;
+                    }
+                    continue;
+                }
+                std::string extra;
+                if (words >> extra) {
+                    return fail("unexpected '" + extra + "'");
+                }
+            }
+            if (open) {
+                return fail("chunk '" + chunks.back().name + "' has no 'end'");
+            }
+            if (chunks.empty()) {
+                return fail("no chunks");
+            }
+            return true;
+        }
+
+    private:
+        // One cell per lane, left to right; spaces between cells are allowed
+        bool parseRow(const std::string& line, SourceChunk& chunk) {
+            std::string row;
+            for (char symbol : line) {
+                if (std::isspace(static_cast<unsigned char>(symbol))) {
+                    continue;
+                }
+                if (symbol != '.' && !findCellCode(symbol)) {
+                    return fail(std::string("unknown cell '") + symbol + "'");
+                }
+                row += symbol;
+            }
+            if (row.size() != static_cast<std::size_t>(LaneSystem::LANE_COUNT)) {
+                return fail("a row needs " + std::to_string(LaneSystem::LANE_COUNT) + " cells, one per lane");
+            }
+            chunk.rows.push_back(row);
+            return true;
+        }
+
+        bool fail(const std::string& message) {
+            mLog << mSourceName << ":" << mLine << ": " << message << "\n";
+            return false;
+        }
+
+        const std::string& mSourceName;
+        std::ostream& mLog;
+        int mLine = 0;
+    };
+
+    // Vose's alias method over one band's chunks
+    void buildAliases(std::vector<ChunkFormat::Chunk>& entries, const std::vector<double>& weights,
+        std::uint32_t first, std::uint32_t count) {
+        double total = 0.0;
+        for (std::uint32_t i = first; i < first + count; ++i) {
+            total += weights[i];
+        }
+        std::vector<double> scaled(count);
+        std::vector<std::uint32_t> small, large;
+        for (std::uint32_t i = 0; i < count; ++i) {
+            scaled[i] = weights[first + i] * count / total;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+        while (!small.empty() && !large.empty()) {
+            const std::uint32_t under = small.back();
+            small.pop_back();
+            const std::uint32_t over = large.back();
+            entries[first + under].keep = static_cast<float>(scaled[under]);
+            entries[first + under].alias = first + over;
+            scaled[over] -= 1.0 - scaled[under];
+            if (scaled[over] < 1.0) {
+                large.pop_back();
+                small.push_back(over);
+            }
+        }
+        // Whatever is left holds (up to rounding) exactly its own share
+        for (const std::vector<std::uint32_t>* rest : { &small, &large }) {
+            for (std::uint32_t i : *rest) {
+                entries[first + i].keep = 1.0f;
+                entries[first + i].alias = first + i;
+            }
+        }
+    }
+
+    template <typename T> void append(std::vector<std::uint8_t>& out, const T* records, std::size_t count) {
+        const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(records);
+        out.insert(out.end(), bytes, bytes + count * sizeof(T));
+    }
+}
+
+bool ChunkLibrary::load(const std::filesystem::path& path) {
+    using namespace ChunkFormat;
+    mHeader = nullptr;
+    if (!mFile.open(path) || mFile.size() < sizeof(Header)) {
+        mFile.close();
+        return false;
+    }
+    const Header* header = reinterpret_cast<const Header*>(mFile.data());
+    const std::uint64_t expectedSize = sizeof(Header) + std::uint64_t(header->bandCount) * sizeof(Band) +
+        std::uint64_t(header->chunkCount) * sizeof(Chunk) + std::uint64_t(header->cellCount) * sizeof(Cell) +
+        header->nameBytes;
+    if (!std::equal(std::begin(kMagic), std::end(kMagic), header->magic) || header->version != VERSION ||
+        header->bandCount != BAND_COUNT || expectedSize != mFile.size()) {
+        mFile.close();
+        return false;
+    }
+    mBands = reinterpret_cast<const Band*>(header + 1);
+    mChunks = reinterpret_cast<const Chunk*>(mBands + header->bandCount);
+    mCells = reinterpret_cast<const Cell*>(mChunks + header->chunkCount);
+    mNames = reinterpret_cast<const char*>(mCells + header->cellCount);
+    mHeader = header;
+    if (!validate()) {
+        mHeader = nullptr;
+        mFile.close();
+        return false;
+    }
+    return true;
+}
+
+bool ChunkLibrary::validate() const {
+    using namespace ChunkFormat;
+    const std::uint8_t* body = reinterpret_cast<const std::uint8_t*>(mHeader + 1);
+    if (hashBytes(body, mFile.size() - sizeof(Header)) != mHeader->hash ||
+        (mHeader->chunkCount > 0 && (mHeader->nameBytes == 0 || mNames[mHeader->nameBytes - 1] != '\0'))) {
+        return false;
+    }
+    // Picks and instantiations trust these, so every index is checked once here
+    std::uint32_t nextChunk = 0;
+    for (std::uint32_t band = 0; band < BAND_COUNT; ++band) {
+        const Band& entry = mBands[band];
+        if (entry.firstChunk != nextChunk || entry.chunkCount > mHeader->chunkCount - nextChunk) {
+            return false;
+        }
+        nextChunk += entry.chunkCount;
+        for (std::uint32_t i = entry.firstChunk; i < nextChunk; ++i) {
+            const Chunk& chunk = mChunks[i];
+            if (chunk.alias < entry.firstChunk || chunk.alias >= nextChunk || !(chunk.keep >= 0.0f) ||
+                !(chunk.keep <= 1.0f) || !(chunk.length > 0.0f) || !std::isfinite(chunk.length) ||
+                chunk.name >= mHeader->nameBytes || chunk.firstCell > mHeader->cellCount ||
+                chunk.cellCount > mHeader->cellCount - chunk.firstCell) {
+                return false;
+            }
+        }
+    }
+    if (nextChunk != mHeader->chunkCount) {
+        return false;
+    }
+    for (std::uint32_t i = 0; i < mHeader->cellCount; ++i) {
+        const Cell& cell = mCells[i];
+        const std::uint8_t types = cell.archetype == Archetype::COIN ? 1 : 4; // four obstacle and power-up kinds
+        if (cell.lane >= LaneSystem::LANE_COUNT || cell.archetype > Archetype::COIN || cell.type >= types ||
+            !(cell.ahead >= 0.0f) || !std::isfinite(cell.ahead)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int ChunkLibrary::bandForSpeed(float speed) {
+    const int band = static_cast<int>(std::floor((speed - 300.0f) / 200.0f));
+    return std::clamp(band, 0, static_cast<int>(ChunkFormat::BAND_COUNT) - 1);
+}
+
+std::size_t ChunkLibrary::pick(int band, std::mt19937& rng) const {
+    if (!mHeader || band < 0 || band >= static_cast<int>(ChunkFormat::BAND_COUNT) || mBands[band].chunkCount == 0) {
+        return NO_CHUNK;
+    }
+    const ChunkFormat::Band& entry = mBands[band];
+    std::uniform_int_distribution<std::uint32_t> chunkDist(0, entry.chunkCount - 1);
+    std::uniform_real_distribution<float> keepDist(0.0f, 1.0f);
+    const std::size_t chunk = entry.firstChunk + chunkDist(rng);
+    return keepDist(rng) < mChunks[chunk].keep ? chunk : mChunks[chunk].alias;
+}
+
+bool compileChunkLibrary(std::istream& source, const std::string& sourceName,
+    const std::filesystem::path& output, std::ostream& log) {
+    using namespace ChunkFormat;
+    std::vector<SourceChunk> chunks;
+    if (!ChunkParser(sourceName, log).parse(source, chunks)) {
+        return false;
+    }
+    std::stable_sort(chunks.begin(), chunks.end(),
+        [](const SourceChunk& a, const SourceChunk& b) { return a.band < b.band; });
+
+    std::vector<Band> bands(BAND_COUNT, Band{ 0, 0 });
+    std::vector<Chunk> entries;
+    std::vector<double> weights;
+    std::vector<Cell> cells;
+    std::string names;
+    entries.reserve(chunks.size());
+    for (const SourceChunk& chunk : chunks) {
+        Chunk entry{};
+        entry.firstCell = static_cast<std::uint32_t>(cells.size());
+        entry.length = chunk.spacing * static_cast<float>(chunk.rows.size());
+        entry.name = static_cast<std::uint32_t>(names.size());
+        // Nearest row first, so spawns append to the world's lane lists
+        for (std::size_t row = chunk.rows.size(); row-- > 0;) {
+            const float ahead = chunk.spacing * static_cast<float>(chunk.rows.size() - 1 - row);
+            for (int lane = 0; lane < LaneSystem::LANE_COUNT; ++lane) {
+                const CellCode* code = findCellCode(chunk.rows[row][lane]);
+                if (code) {
+                    cells.push_back(Cell{ ahead, static_cast<std::uint8_t>(lane), code->archetype, code->type, 0 });
+                }
+            }
+        }
+        entry.cellCount = static_cast<std::uint32_t>(cells.size()) - entry.firstCell;
+        names += chunk.name;
+        names += '\0';
+        bands[chunk.band].chunkCount++;
+        entries.push_back(entry);
+        weights.push_back(chunk.weight);
+    }
+    std::uint32_t firstChunk = 0;
+    for (Band& band : bands) {
+        band.firstChunk = firstChunk;
+        buildAliases(entries, weights, firstChunk, band.chunkCount);
+        firstChunk += band.chunkCount;
+    }
+
+    std::vector<std::uint8_t> body;
+    append(body, bands.data(), bands.size());
+    append(body, entries.data(), entries.size());
+    append(body, cells.data(), cells.size());
+    append(body, names.data(), names.size());
+    Header header;
+    std::copy(std::begin(kMagic), std::end(kMagic), header.magic);
+    header.version = VERSION;
+    header.bandCount = BAND_COUNT;
+    header.chunkCount = static_cast<std::uint32_t>(entries.size());
+    header.cellCount = static_cast<std::uint32_t>(cells.size());
+    header.nameBytes = static_cast<std::uint32_t>(names.size());
+    header.hash = hashBytes(body.data(), body.size());
+
+    // Written next to 'output' and renamed over it: a running game keeps
+    // its mapping of the old file
+    std::error_code ec;
+    if (output.has_parent_path()) {
+        std::filesystem::create_directories(output.parent_path(), ec);
+    }
+    std::filesystem::path temp = output;
+    temp += ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+        if (!file) {
+            log << "Could not write " << temp.string() << "\n";
+            return false;
+        }
+    }
+    std::filesystem::rename(temp, output, ec);
+    if (ec) {
+        log << "Could not replace " << output.string() << ": " << ec.message() << "\n";
+        return false;
+    }
+    log << "Compiled " << entries.size() << " chunks (" << cells.size() << " cells) into " << output.string() << "\n";
+    return true;
+}
+
+bool compileChunkLibrary(const std::filesystem::path& source, const std::filesystem::path& output, std::ostream& log) {
+    std::ifstream file(source);
+    if (!file) {
+        log << "Could not read " << source.string() << "\n";
+        return false;
+    }
+    return compileChunkLibrary(file, source.string(), output, log);
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include "EntityWorld.h"
+#include "LaneSystem.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <string>
+
+// Chunk library files: a Header, then BAND_COUNT Bands, chunkCount Chunks
+// (sorted by band), cellCount Cells (grouped by chunk) and nameBytes of
+// nul-terminated chunk names. Native byte order, every record 4-byte
+// aligned, so the mapped file is used in place. Bump VERSION whenever a
+// record changes.
+namespace ChunkFormat {
+    constexpr std::uint32_t VERSION = 1;
+    constexpr std::uint32_t BAND_COUNT = 4;
+
+    struct Header {
+        char magic[4]; // "MCHK"
+        std::uint32_t version;
+        std::uint32_t bandCount;
+        std::uint32_t chunkCount;
+        std::uint32_t cellCount;
+        std::uint32_t nameBytes;
+        std::uint64_t hash; // FNV-1a of everything after the header
+    };
+
+    struct Band {
+        std::uint32_t firstChunk;
+        std::uint32_t chunkCount;
+    };
+
+    // Weighted picks use Vose's alias method: a uniform chunk of the band,
+    // kept with probability 'keep' and swapped for 'alias' otherwise.
+    struct Chunk {
+        std::uint32_t firstCell;
+        std::uint32_t cellCount;
+        float length; // pixels of track the chunk occupies
+        float keep;
+        std::uint32_t alias;
+        std::uint32_t name; // offset into the names
+    };
+
+    struct Cell {
+        float ahead; // pixels above the chunk's nearest row
+        std::uint8_t lane;
+        Archetype archetype;
+        std::uint8_t type; // ObstacleType or PowerUpType; unused for coins
+        std::uint8_t padding;
+    };
+
+    static_assert(sizeof(Header) == 32 && sizeof(Band) == 8 && sizeof(Chunk) == 24 && sizeof(Cell) == 8,
+        "chunk records must keep their file layout");
+}
+
+// Hand-authored track sections: lane x distance grids of obstacles, coins
+// and power-ups, written as text (see data/chunks.txt), compiled by
+// compileChunkLibrary() and mapped read-only at startup.
+//
+// Nothing is parsed or copied when a library loads, and a pick or an
+// instantiation touches only its band, its chunk and the chunk's cells, so
+// neither gets slower as the library grows. One library is shared
+// read-only by every Simulation using it and must outlive them.
+class ChunkLibrary {
+public:
+    static constexpr std::size_t NO_CHUNK = static_cast<std::size_t>(-1);
+
+    ChunkLibrary() = default;
+    ChunkLibrary(const ChunkLibrary&) = delete;
+    ChunkLibrary& operator=(const ChunkLibrary&) = delete;
+
+    // Returns false (leaving the library empty) for a missing, foreign,
+    // old-version or damaged file.
+    bool load(const std::filesystem::path& path);
+    bool isLoaded() const { return mHeader != nullptr; }
+
+    // Identifies the library's contents; replays and snapshots record it.
+    std::uint64_t getHash() const { return mHeader ? mHeader->hash : 0; }
+
+    std::size_t getChunkCount() const { return mHeader ? mHeader->chunkCount : 0; }
+    std::size_t getChunkCount(int band) const { return mHeader ? mBands[band].chunkCount : 0; }
+    const char* getName(std::size_t chunk) const { return mNames + mChunks[chunk].name; }
+    float getLength(std::size_t chunk) const { return mChunks[chunk].length; }
+
+    // Difficulty band for a track speed: 0 below 500 px/s, then one more
+    // every 200 px/s, up to BAND_COUNT - 1.
+    static int bandForSpeed(float speed);
+
+    // A chunk of 'band' picked in proportion to the authored weights, or
+    // NO_CHUNK if the band has none.
+    std::size_t pick(int band, std::mt19937& rng) const;
+
+    // Spawns the chunk with its nearest row on 'spawnY' into 'target' (an
+    // EntityWorld or a SpawnList) and returns its length.
+    template <typename Target> float instantiate(std::size_t chunk, Target& target, float spawnY) const;
+
+private:
+    bool validate() const;
+
+    MappedFile mFile;
+    const ChunkFormat::Header* mHeader = nullptr;
+    const ChunkFormat::Band* mBands = nullptr;
+    const ChunkFormat::Chunk* mChunks = nullptr;
+    const ChunkFormat::Cell* mCells = nullptr;
+    const char* mNames = nullptr;
+};
+
+template <typename Target>
+float ChunkLibrary::instantiate(std::size_t chunk, Target& target, float spawnY) const {
+    const ChunkFormat::Chunk& entry = mChunks[chunk];
+    const ChunkFormat::Cell* end = mCells + entry.firstCell + entry.cellCount;
+    for (const ChunkFormat::Cell* cell = mCells + entry.firstCell; cell != end; ++cell) {
+        const float x = LaneSystem::getLaneCenter(cell->lane);
+        const float y = spawnY - cell->ahead;
+        switch (cell->archetype) {
+        case Archetype::OBSTACLE:
+            target.spawnObstacle(static_cast<ObstacleType>(cell->type), x, y);
+            break;
+        case Archetype::POWER_UP:
+            target.spawnPowerUp(static_cast<PowerUpType>(cell->type), x, y);
+            break;
+        case Archetype::COIN:
+            target.spawnCoin(x, y);
+            break;
+        }
+    }
+    return entry.length;
+}
+
+// Compiles chunk source text into a library file, replacing 'output' only
+// once the whole source compiled. Errors go to 'log' as
+// "source:line: message".
+bool compileChunkLibrary(std::istream& source, const std::string& sourceName,
+    const std::filesystem::path& output, std::ostream& log);
+bool compileChunkLibrary(const std::filesystem::path& source, const std::filesystem::path& output, std::ostream& log);
@@ -0,0 +1,197 @@
+#include "CoinStore.h"
+#include "Simd.h"
+
+namespace {
+    int popCount(unsigned int bits) {
+        int count = 0;
+        while (bits) {
+            bits &= bits - 1;
+            ++count;
+        }
+        return count;
+    }
+
+    // --- Kernels ---
+    // Each kernel handles the widest vector width available, then finishes
+    // the remainder with the scalar loop (which is also the fallback path).
+
+    void scrollKernel(float* y, float* rotation, std::size_t count, float dy, float dRotation) {
+        std::size_t i = 0;
+#if defined(TRACK_SIMD_AVX)
+        const __m256 vdy = _mm256_set1_ps(dy);
+        const __m256 vdr = _mm256_set1_ps(dRotation);
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), vdy));
+            _mm256_storeu_ps(rotation + i, _mm256_add_ps(_mm256_loadu_ps(rotation + i), vdr));
+        }
+#elif defined(TRACK_SIMD_SSE)
+        const __m128 vdy = _mm_set1_ps(dy);
+        const __m128 vdr = _mm_set1_ps(dRotation);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), vdy));
+            _mm_storeu_ps(rotation + i, _mm_add_ps(_mm_loadu_ps(rotation + i), vdr));
+        }
+#endif
+        for (; i < count; ++i) {
+            y[i] += dy;
+            rotation[i] += dRotation;
+        }
+    }
+
+    void attractKernel(float* x, float* y, const float* alive, std::size_t count,
+        float targetX, float targetY, float radiusSq, float pull) {
+        std::size_t i = 0;
+#if defined(TRACK_SIMD_AVX)
+        const __m256 vtx = _mm256_set1_ps(targetX);
+        const __m256 vty = _mm256_set1_ps(targetY);
+        const __m256 vr2 = _mm256_set1_ps(radiusSq);
+        const __m256 vpull = _mm256_set1_ps(pull);
+        const __m256 zero = _mm256_setzero_ps();
+        for (; i + 8 <= count; i += 8) {
+            __m256 px = _mm256_loadu_ps(x + i);
+            __m256 py = _mm256_loadu_ps(y + i);
+            __m256 dx = _mm256_sub_ps(vtx, px);
+            __m256 dy = _mm256_sub_ps(vty, py);
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 inRange = _mm256_and_ps(_mm256_cmp_ps(d2, vr2, _CMP_LT_OQ),
+                _mm256_cmp_ps(_mm256_loadu_ps(alive + i), zero, _CMP_GT_OQ));
+            _mm256_storeu_ps(x + i, _mm256_add_ps(px, _mm256_and_ps(inRange, _mm256_mul_ps(dx, vpull))));
+            _mm256_storeu_ps(y + i, _mm256_add_ps(py, _mm256_and_ps(inRange, _mm256_mul_ps(dy, vpull))));
+        }
+#elif defined(TRACK_SIMD_SSE)
+        const __m128 vtx = _mm_set1_ps(targetX);
+        const __m128 vty = _mm_set1_ps(targetY);
+        const __m128 vr2 = _mm_set1_ps(radiusSq);
+        const __m128 vpull = _mm_set1_ps(pull);
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            __m128 px = _mm_loadu_ps(x + i);
+            __m128 py = _mm_loadu_ps(y + i);
+            __m128 dx = _mm_sub_ps(vtx, px);
+            __m128 dy = _mm_sub_ps(vty, py);
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            __m128 inRange = _mm_and_ps(_mm_cmplt_ps(d2, vr2), _mm_cmpgt_ps(_mm_loadu_ps(alive + i), zero));
+            _mm_storeu_ps(x + i, _mm_add_ps(px, _mm_and_ps(inRange, _mm_mul_ps(dx, vpull))));
+            _mm_storeu_ps(y + i, _mm_add_ps(py, _mm_and_ps(inRange, _mm_mul_ps(dy, vpull))));
+        }
+#endif
+        for (; i < count; ++i) {
+            float dx = targetX - x[i];
+            float dy = targetY - y[i];
+            if (alive[i] > 0.0f && dx * dx + dy * dy < radiusSq) {
+                x[i] += dx * pull;
+                y[i] += dy * pull;
+            }
+        }
+    }
+
+    int collectKernel(const float* x, const float* y, float* alive, std::size_t count,
+        float left, float top, float right, float bottom, float radius) {
+        int collected = 0;
+        std::size_t i = 0;
+#if defined(TRACK_SIMD_AVX)
+        const __m256 vr = _mm256_set1_ps(radius);
+        const __m256 vl = _mm256_set1_ps(left);
+        const __m256 vt = _mm256_set1_ps(top);
+        const __m256 vri = _mm256_set1_ps(right);
+        const __m256 vb = _mm256_set1_ps(bottom);
+        const __m256 zero = _mm256_setzero_ps();
+        for (; i + 8 <= count; i += 8) {
+            __m256 px = _mm256_loadu_ps(x + i);
+            __m256 py = _mm256_loadu_ps(y + i);
+            __m256 live = _mm256_loadu_ps(alive + i);
+            __m256 hit = _mm256_and_ps(
+                _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(px, vr), vri, _CMP_LT_OQ),
+                    _mm256_cmp_ps(_mm256_add_ps(px, vr), vl, _CMP_GT_OQ)),
+                _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(py, vr), vb, _CMP_LT_OQ),
+                    _mm256_cmp_ps(_mm256_add_ps(py, vr), vt, _CMP_GT_OQ)));
+            hit = _mm256_and_ps(hit, _mm256_cmp_ps(live, zero, _CMP_GT_OQ));
+            _mm256_storeu_ps(alive + i, _mm256_andnot_ps(hit, live));
+            collected += popCount(static_cast<unsigned int>(_mm256_movemask_ps(hit)));
+        }
+#elif defined(TRACK_SIMD_SSE)
+        const __m128 vr = _mm_set1_ps(radius);
+        const __m128 vl = _mm_set1_ps(left);
+        const __m128 vt = _mm_set1_ps(top);
+        const __m128 vri = _mm_set1_ps(right);
+        const __m128 vb = _mm_set1_ps(bottom);
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            __m128 px = _mm_loadu_ps(x + i);
+            __m128 py = _mm_loadu_ps(y + i);
+            __m128 live = _mm_loadu_ps(alive + i);
+            __m128 hit = _mm_and_ps(
+                _mm_and_ps(_mm_cmplt_ps(_mm_sub_ps(px, vr), vri), _mm_cmpgt_ps(_mm_add_ps(px, vr), vl)),
+                _mm_and_ps(_mm_cmplt_ps(_mm_sub_ps(py, vr), vb), _mm_cmpgt_ps(_mm_add_ps(py, vr), vt)));
+            hit = _mm_and_ps(hit, _mm_cmpgt_ps(live, zero));
+            _mm_storeu_ps(alive + i, _mm_andnot_ps(hit, live));
+            collected += popCount(static_cast<unsigned int>(_mm_movemask_ps(hit)));
+        }
+#endif
+        for (; i < count; ++i) {
+            if (alive[i] > 0.0f && x[i] - radius < right && x[i] + radius > left &&
+                y[i] - radius < bottom && y[i] + radius > top) {
+                alive[i] = 0.0f;
+                ++collected;
+            }
+        }
+        return collected;
+    }
+}
+
+CoinStore::CoinStore(std::size_t capacity) {
+    reserve(capacity);
+}
+
+void CoinStore::spawn(float x, float y, EntityHandle handle) {
+    mX.push_back(x);
+    mY.push_back(y);
+    mRotation.push_back(0.0f);
+    mAlive.push_back(1.0f);
+    mHandles.push_back(handle);
+}
+
+void CoinStore::reserve(std::size_t capacity) {
+    mX.reserve(capacity);
+    mY.reserve(capacity);
+    mRotation.reserve(capacity);
+    mAlive.reserve(capacity);
+    mHandles.reserve(capacity);
+}
+
+void CoinStore::clear() {
+    mX.clear();
+    mY.clear();
+    mRotation.clear();
+    mAlive.clear();
+    mHandles.clear();
+}
+
+void CoinStore::scroll(float dy, float dRotation) {
+    scrollKernel(mY.data(), mRotation.data(), mY.size(), dy, dRotation);
+}
+
+void CoinStore::attract(sf::Vector2f target, float radius, float pull) {
+    attractKernel(mX.data(), mY.data(), mAlive.data(), mX.size(), target.x, target.y,
+        radius * radius, pull);
+}
+
+int CoinStore::collect(const sf::FloatRect& bounds) {
+    return collectKernel(mX.data(), mY.data(), mAlive.data(), mX.size(), bounds.left, bounds.top,
+        bounds.left + bounds.width, bounds.top + bounds.height, RADIUS);
+}
+
+void CoinStore::saveState(SnapshotWriter& writer) const {
+    writer.values(mX);
+    writer.values(mY);
+    writer.values(mRotation);
+    writer.values(mAlive);
+    writer.values(mHandles);
+}
+
+bool CoinStore::loadState(SnapshotReader& reader) {
+    const bool ok = reader.values(mX) && reader.values(mY) && reader.values(mRotation) && reader.values(mAlive) &&
+        reader.values(mHandles);
+    const std::size_t count = mX.size();
+    return ok && mY.size() == count && mRotation.size() == count && mAlive.size() == count && mHandles.size() == count;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "EntityHandle.h"
+#include "Snapshot.h"
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <vector>
+
+// Coins stored as parallel arrays (structure of arrays) instead of one heap
+// object per coin. The per-frame work - scrolling, magnet pull and pickup
+// against the player - runs as straight loops over contiguous floats, using
+// SSE/AVX when the compiler targets them and a scalar loop otherwise.
+class CoinStore {
+public:
+    static constexpr float RADIUS = 15.0f;
+    static constexpr float SPIN_SPEED = 180.0f; // degrees per second
+    static constexpr float DESPAWN_Y = 800.0f; // Screen height + buffer
+
+    explicit CoinStore(std::size_t capacity = 0);
+
+    void spawn(float x, float y, EntityHandle handle = EntityHandle());
+    void reserve(std::size_t capacity);
+    void clear();
+
+    // Moves every coin down by 'dy' and spins it by 'dRotation' degrees.
+    void scroll(float dy, float dRotation);
+
+    // Pulls coins within 'radius' of 'target' towards it by 'pull' (0..1) of
+    // the remaining distance. Uses a squared-distance test, no sqrt.
+    void attract(sf::Vector2f target, float radius, float pull);
+
+    // Marks every live coin overlapping 'bounds' as collected and returns how
+    // many were picked up.
+    int collect(const sf::FloatRect& bounds);
+
+    // Drops collected coins and coins that scrolled off screen.
+    void compact() {
+        compact([](EntityHandle) {}, [](EntityHandle, std::size_t) {});
+    }
+
+    // Same, reporting each dropped coin's handle and the new row of every
+    // coin that moved so an owner can keep its handle mapping current.
+    template <typename OnRemove, typename OnMove> void compact(OnRemove onRemove, OnMove onMove) {
+        std::size_t writeIdx = 0;
+        const std::size_t count = mX.size();
+        for (std::size_t readIdx = 0; readIdx < count; ++readIdx) {
+            if (mAlive[readIdx] == 0.0f || mY[readIdx] > DESPAWN_Y) {
+                onRemove(mHandles[readIdx]);
+                continue;
+            }
+            if (writeIdx != readIdx) {
+                mX[writeIdx] = mX[readIdx];
+                mY[writeIdx] = mY[readIdx];
+                mRotation[writeIdx] = mRotation[readIdx];
+                mAlive[writeIdx] = mAlive[readIdx];
+                mHandles[writeIdx] = mHandles[readIdx];
+                onMove(mHandles[writeIdx], writeIdx);
+            }
+            writeIdx++;
+        }
+        mX.resize(writeIdx);
+        mY.resize(writeIdx);
+        mRotation.resize(writeIdx);
+        mAlive.resize(writeIdx);
+        mHandles.resize(writeIdx);
+    }
+
+    std::size_t size() const { return mX.size(); }
+    std::size_t capacity() const { return mX.capacity(); }
+    sf::Vector2f getPosition(std::size_t index) const { return sf::Vector2f(mX[index], mY[index]); }
+    float getRotation(std::size_t index) const { return mRotation[index]; }
+    bool isAlive(std::size_t index) const { return mAlive[index] != 0.0f; }
+    void kill(std::size_t index) { mAlive[index] = 0.0f; }
+    EntityHandle getHandle(std::size_t index) const { return mHandles[index]; }
+
+    void saveState(SnapshotWriter& writer) const;
+    bool loadState(SnapshotReader& reader);
+
+private:
+    std::vector<float> mX;
+    std::vector<float> mY;
+    std::vector<float> mRotation;
+    std::vector<float> mAlive; // 1.0f alive, 0.0f collected (keeps the kernels branch-free)
+    std::vector<EntityHandle> mHandles;
+};
@@ -0,0 +1,51 @@
+#pragma once
+#include "EntityHandle.h"
+#include "Obstacle.h"
+#include "PowerUp.h"
+#include <cstdint>
+
+// Plain-data components stored in the EntityWorld archetype tables.
+
+struct Position {
+    float x;
+    float y;
+};
+
+// Motion relative to the track. 'scroll' is a multiple of the game speed
+// (1 = parked on the track), 'spin' is in degrees per second.
+struct Velocity {
+    float scroll;
+    float spin;
+};
+
+// Axis-aligned box as offsets from Position (left/top are usually negative).
+struct Extent {
+    float left;
+    float top;
+    float right;
+    float bottom;
+};
+
+enum class SpriteId : std::uint8_t {
+    TRAIN, BARRIER, CONE, FENCE,
+    MAGNET, JETPACK, SHIELD, DOUBLE_COIN
+};
+
+struct Render {
+    SpriteId sprite;
+    float rotation;
+};
+
+struct ObstacleBehaviour {
+    ObstacleType type;
+};
+
+struct PowerUpBehaviour {
+    PowerUpType type;
+};
+
+// Set by EntityWorld::destroy(); systems skip the row until the next
+// compaction pass reclaims it.
+struct Status {
+    bool dead;
+};
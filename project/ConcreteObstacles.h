@@ -1,45 +1,51 @@
-#pragma once
-#include "Obstacle.h"
-
-class BaseObstacle : public Obstacle {
-public:
-	BaseObstacle(float x, float y, float width, float height, sf::Color color);
-	void update(sf::Time dt, float gameSpeed) override;
-	void draw(sf::RenderWindow& window) override;
-	sf::FloatRect getBounds() const override;
-	bool isRemovable() const override;
-	void setPosition(sf::Vector2f pos) override;
-	sf::Vector2f getPosition() const override;
-
-protected:
-	sf::RectangleShape mShape;
-};
-
-class Train : public BaseObstacle {
-public:
-	Train(float x, float y);
-	bool onCollision(Player& player) override;
-	ObstacleType getType() const override { return ObstacleType::TRAIN; }
-};
-
-class Barrier : public BaseObstacle {
-public:
-	Barrier(float x, float y);
-	bool onCollision(Player& player) override;
-	ObstacleType getType() const override { return ObstacleType::BARRIER; }
-};
-
-class Cone : public BaseObstacle {
-public:
-	Cone(float x, float y);
-	bool onCollision(Player& player) override;
-	ObstacleType getType() const override { return ObstacleType::CONE; }
-};
-
-class Fence : public BaseObstacle {
-public:
-	Fence(float x, float y);
-	bool onCollision(Player& player) override;
-	ObstacleType getType() const override { return ObstacleType::FENCE; }
-};
-#pragma once
+#pragma once
+#pragma once
+#include "Obstacle.h"
+
+// Obstacle origin is at the bottom center: bounds span
+// [x - WIDTH / 2, x + WIDTH / 2] x [y - HEIGHT, y].
+
+struct Train {
+	static constexpr ObstacleType TYPE = ObstacleType::TRAIN;
+	static constexpr const char* NAME = "train";
+	static constexpr float WIDTH = 100.0f;
+	static constexpr float HEIGHT = 200.0f;
+	static constexpr float SPAWN_WEIGHT = 1.0f;
+	static constexpr std::uint8_t CLEARANCE = CLEAR_NONE;
+	static bool onCollision(const Player& player, const sf::FloatRect& bounds);
+};
+
+struct Barrier {
+	static constexpr ObstacleType TYPE = ObstacleType::BARRIER;
+	static constexpr const char* NAME = "barrier";
+	static constexpr float WIDTH = 120.0f;
+	static constexpr float HEIGHT = 80.0f;
+	static constexpr float SPAWN_WEIGHT = 1.0f;
+	static constexpr std::uint8_t CLEARANCE = CLEAR_BY_JUMP | CLEAR_BY_SLIDE;
+	static bool onCollision(const Player& player, const sf::FloatRect& bounds);
+};
+
+struct Cone {
+	static constexpr ObstacleType TYPE = ObstacleType::CONE;
+	static constexpr const char* NAME = "cone";
+	static constexpr float WIDTH = 40.0f;
+	static constexpr float HEIGHT = 40.0f;
+	static constexpr float SPAWN_WEIGHT = 1.0f;
+	static constexpr std::uint8_t CLEARANCE = CLEAR_BY_JUMP;
+	static bool onCollision(const Player& player, const sf::FloatRect& bounds);
+};
+
+struct Fence {
+	static constexpr ObstacleType TYPE = ObstacleType::FENCE;
+	static constexpr const char* NAME = "fence";
+	static constexpr float WIDTH = 150.0f;
+	static constexpr float HEIGHT = 100.0f;
+	static constexpr float SPAWN_WEIGHT = 1.0f;
+	static constexpr std::uint8_t CLEARANCE = CLEAR_BY_JUMP | CLEAR_BY_SLIDE;
+	static bool onCollision(const Player& player, const sf::FloatRect& bounds);
+};
+
+// Every obstacle kind, in ObstacleType order. New kinds are registered here.
+using ObstacleRegistry = EntityRegistry<Train, Barrier, Cone, Fence>;
+
+inline const ObstacleSpec& getObstacleSpec(ObstacleType type) { return ObstacleRegistry::spec(type); }
@@ -1,45 +1,40 @@
-#pragma once
-#include "PowerUp.h"
-
-class BasePowerUp : public PowerUp {
-public:
-	BasePowerUp(float x, float y, sf::Color color);
-	void update(sf::Time dt, float gameSpeed) override;
-	void draw(sf::RenderWindow& window) override;
-	sf::FloatRect getBounds() const override;
-	bool isRemovable() const override;
-	void setPosition(sf::Vector2f pos) override;
-	sf::Vector2f getPosition() const override;
-
-protected:
-	sf::CircleShape mShape;
-};
-
-class MagnetPower : public BasePowerUp {
-public:
-	MagnetPower(float x, float y);
-	void applyEffect(Player& player) override;
-	PowerUpType getType() const override { return PowerUpType::MAGNET; }
-};
-
-class JetpackPower : public BasePowerUp {
-public:
-	JetpackPower(float x, float y);
-	void applyEffect(Player& player) override;
-	PowerUpType getType() const override { return PowerUpType::JETPACK; }
-};
-
-class ShieldPower : public BasePowerUp {
-public:
-	ShieldPower(float x, float y);
-	void applyEffect(Player& player) override;
-	PowerUpType getType() const override { return PowerUpType::SHIELD; }
-};
-
-class DoubleCoinPower : public BasePowerUp {
-public:
-	DoubleCoinPower(float x, float y);
-	void applyEffect(Player& player) override;
-	PowerUpType getType() const override { return PowerUpType::DOUBLE_COIN; }
-};
-#pragma once
+#pragma once
+#pragma once
+#include "PowerUp.h"
+
+struct MagnetPower {
+	static constexpr PowerUpType TYPE = PowerUpType::MAGNET;
+	static constexpr const char* NAME = "magnet";
+	static constexpr float RADIUS = 20.0f;
+	static constexpr float SPAWN_WEIGHT = 1.0f;
+	static void applyEffect(Player& player);
+};
+
+struct JetpackPower {
+	static constexpr PowerUpType TYPE = PowerUpType::JETPACK;
+	static constexpr const char* NAME = "jetpack";
+	static constexpr float RADIUS = 20.0f;
+	static constexpr float SPAWN_WEIGHT = 1.0f;
+	static void applyEffect(Player& player);
+};
+
+struct ShieldPower {
+	static constexpr PowerUpType TYPE = PowerUpType::SHIELD;
+	static constexpr const char* NAME = "shield";
+	static constexpr float RADIUS = 20.0f;
+	static constexpr float SPAWN_WEIGHT = 1.0f;
+	static void applyEffect(Player& player);
+};
+
+struct DoubleCoinPower {
+	static constexpr PowerUpType TYPE = PowerUpType::DOUBLE_COIN;
+	static constexpr const char* NAME = "doubleCoin";
+	static constexpr float RADIUS = 20.0f;
+	static constexpr float SPAWN_WEIGHT = 1.0f;
+	static void applyEffect(Player& player);
+};
+
+// Every power-up kind, in PowerUpType order. New kinds are registered here.
+using PowerUpRegistry = EntityRegistry<MagnetPower, JetpackPower, ShieldPower, DoubleCoinPower>;
+
+inline const PowerUpSpec& getPowerUpSpec(PowerUpType type) { return PowerUpRegistry::spec(type); }
@@ -0,0 +1,271 @@
+#include "EntityBenchmark.h"
+#include "ChunkLibrary.h"
+#include "ConcreteObstacles.h"
+#include "EntitySystems.h"
+#include "GameObject.h"
+#include "LaneGrid.h"
+#include "LaneSystem.h"
+#include "TrackManager.h"
+#include <SFML/System.hpp>
+#include <filesystem>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+    const float kGameSpeed = 600.0f;
+    const float kTopY = -3000.0f;
+    const float kBottomY = 800.0f;
+    const sf::Time kFrameTime = sf::seconds(1.0f / 60.0f);
+    const std::size_t kChunksPerBatch = 256; // instantiated between world clears
+
+    // Keeps the legacy narrow-phase results observable so the loop is not optimised away.
+    volatile std::size_t gLegacyHits = 0;
+    volatile std::uint16_t gSafeStates = 0;
+
+    // Stand-in for the pre-ECS BaseObstacle: one heap object per obstacle
+    // wrapping an sf::RectangleShape, reached through virtual calls.
+    class LegacyObstacle : public GameObject {
+    public:
+        LegacyObstacle(ObstacleType type, float x, float y) : mSpec(getObstacleSpec(type)) {
+            mShape.setPosition(sf::Vector2f(x, y));
+            mShape.setSize(sf::Vector2f(mSpec.width, mSpec.height));
+            mShape.setOrigin(sf::Vector2f(mSpec.width / 2.0f, mSpec.height));
+        }
+
+        void update(sf::Time dt, float gameSpeed) override { mShape.move(sf::Vector2f(0, gameSpeed * dt.asSeconds())); }
+        void draw(sf::RenderWindow& window) override { window.draw(mShape); }
+        sf::FloatRect getBounds() const override { return mShape.getGlobalBounds(); }
+        bool isRemovable() const override { return mShape.getPosition().y > kBottomY; }
+        void setPosition(sf::Vector2f pos) override { mShape.setPosition(pos); }
+        sf::Vector2f getPosition() const override { return mShape.getPosition(); }
+
+        virtual bool onCollision(const Player& player) { return mSpec.onCollision(player, getBounds()); }
+
+    private:
+        const ObstacleSpec& mSpec;
+        sf::RectangleShape mShape;
+    };
+
+    // Deterministic layout: entities evenly spread over [kTopY, kBottomY],
+    // cycling through lanes and obstacle types.
+    void placement(std::size_t index, std::size_t count, ObstacleType& type, float& x, float& y) {
+        type = static_cast<ObstacleType>(index % 4);
+        x = LaneSystem::getLaneCenter(static_cast<int>(index % LaneSystem::LANE_COUNT));
+        y = kTopY + (kBottomY - kTopY) * static_cast<float>(index) / static_cast<float>(count);
+    }
+
+    double benchLegacy(std::size_t entityCount, int frames, const Player& player) {
+        std::vector<std::unique_ptr<LegacyObstacle>> list;
+        list.reserve(entityCount);
+        for (std::size_t i = 0; i < entityCount; ++i) {
+            ObstacleType type;
+            float x, y;
+            placement(i, entityCount, type, x, y);
+            list.push_back(std::make_unique<LegacyObstacle>(type, x, y));
+        }
+
+        sf::FloatRect playerBounds = player.getBounds();
+        std::size_t hits = 0;
+        std::size_t respawned = 0;
+        sf::Clock clock;
+        for (int frame = 0; frame < frames; ++frame) {
+            for (auto& obs : list) {
+                obs->update(kFrameTime, kGameSpeed);
+            }
+            std::erase_if(list, [](const std::unique_ptr<LegacyObstacle>& obs) { return obs->isRemovable(); });
+            for (auto& obs : list) {
+                if (obs->getBounds().intersects(playerBounds) && obs->onCollision(player)) {
+                    hits++;
+                }
+            }
+            while (list.size() < entityCount) {
+                ObstacleType type;
+                float x, y;
+                placement(respawned++, entityCount, type, x, y);
+                list.push_back(std::make_unique<LegacyObstacle>(type, x, kTopY));
+            }
+        }
+        double elapsed = clock.getElapsedTime().asMicroseconds() / static_cast<double>(frames);
+        gLegacyHits = hits;
+        return elapsed;
+    }
+
+    double benchWorld(std::size_t entityCount, int frames, Player& player) {
+        EntityWorld world;
+        world.reserve(entityCount, 0, 0);
+        for (std::size_t i = 0; i < entityCount; ++i) {
+            ObstacleType type;
+            float x, y;
+            placement(i, entityCount, type, x, y);
+            world.spawnObstacle(type, x, y);
+        }
+
+        std::size_t respawned = 0;
+        sf::Clock clock;
+        for (int frame = 0; frame < frames; ++frame) {
+            scrollSystem(world, kFrameTime.asSeconds(), kGameSpeed);
+            expireSystem(world);
+            collideSystem(world, player);
+            while (world.getObstacles().size() < entityCount) {
+                ObstacleType type;
+                float x, y;
+                placement(respawned++, entityCount, type, x, y);
+                world.spawnObstacle(type, x, kTopY);
+            }
+        }
+        return clock.getElapsedTime().asMicroseconds() / static_cast<double>(frames);
+    }
+
+    // 'count' chunks of 3-10 rows spread over the bands, about half the
+    // cells filled, in the data/chunks.txt format
+    std::string generateChunks(std::size_t count) {
+        const char kCells[] = "TBCFooooMJSD";
+        std::mt19937 rng(static_cast<unsigned int>(count));
+        std::uniform_int_distribution<int> rowDist(3, 10);
+        std::uniform_int_distribution<int> cellDist(0, 2 * (sizeof(kCells) - 1) - 1);
+        std::ostringstream source;
+        for (std::size_t i = 0; i < count; ++i) {
+            source << "chunk c" << i << "\nband " << i % ChunkFormat::BAND_COUNT << "\nweight " << 1 + i % 3 << "\n";
+            for (int row = rowDist(rng); row > 0; --row) {
+                for (int lane = 0; lane < LaneSystem::LANE_COUNT; ++lane) {
+                    const std::size_t cell = static_cast<std::size_t>(cellDist(rng));
+                    source << (cell < sizeof(kCells) - 1 ? kCells[cell] : '.');
+                }
+                source << "\n";
+            }
+            source << "end\n";
+        }
+        return source.str();
+    }
+    // Ten minutes of track for each of a range of seeds, which reaches top
+    // speed, reporting what the passability check did
+    void generateTracks(const char* name, const ChunkLibrary* chunks, std::ostream& out) {
+        const float kTickSeconds = 1.0f / 60.0f;
+        const std::uint64_t kTicks = 10 * 60 * 60;
+        const unsigned int kSeeds = 32;
+        LaneCheckStats totals;
+        std::uint64_t stuckTicks = 0;
+        for (unsigned int seed = 1; seed <= kSeeds; ++seed) {
+            TrackGenerator generator(TrackCapacityConfig().patterns, seed, chunks);
+            for (std::uint64_t tick = 0; tick < kTicks; ++tick) {
+                generator.generate(kTickSeconds);
+                generator.getSpawns().clear();
+                stuckTicks += generator.getLaneGrid().getSafeStates() == 0 ? 1 : 0;
+            }
+            const LaneCheckStats& stats = generator.getLaneCheckStats();
+            totals.checked += stats.checked;
+            totals.repaired += stats.repaired;
+            totals.rejected += stats.rejected;
+        }
+        out << name << ": " << totals.checked << " obstacle spawns in " << kSeeds << " x 10 min, "
+            << totals.repaired << " repaired, " << totals.rejected << " rejected, " << stuckTicks
+            << " ticks with no way through\n";
+    }
+}
+
+void runEntityBenchmark(std::size_t entityCount, int frames, std::ostream& out) {
+    Player player;
+    player.setInvincible(true); // keep every narrow-phase test non-fatal so both sides do the full scan
+
+    double legacyUs = benchLegacy(entityCount, frames, player);
+    double worldUs = benchWorld(entityCount, frames, player);
+
+    out << "Entities: " << entityCount << ", frames: " << frames << "\n"
+        << "Heap GameObjects:     " << legacyUs << " us/frame\n"
+        << "EntityWorld:          " << worldUs << " us/frame\n";
+    if (worldUs > 0.0) {
+        out << "Speedup: " << legacyUs / worldUs << "x\n";
+    }
+}
+
+void runChunkBenchmark(std::ostream& out) {
+    const std::size_t kInstances = 256 * kChunksPerBatch;
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "chunk-bench.bin";
+    out << std::setw(8) << "chunks" << std::setw(10) << "file KB" << std::setw(10) << "load us" << std::setw(10)
+        << "ns/chunk" << std::setw(10) << "ns/cell" << "\n";
+    for (std::size_t count : { 16, 1024, 16384 }) {
+        std::istringstream source(generateChunks(count));
+        std::ostringstream log;
+        if (!compileChunkLibrary(source, "generated", path, log)) {
+            out << log.str();
+            return;
+        }
+        ChunkLibrary library;
+        sf::Clock loadClock;
+        if (!library.load(path)) {
+            out << "Could not load " << path.string() << "\n";
+            return;
+        }
+        const sf::Int64 loadUs = loadClock.getElapsedTime().asMicroseconds();
+
+        EntityWorld world;
+        world.reserve(kChunksPerBatch * 32, kChunksPerBatch * 4, kChunksPerBatch * 32);
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<int> bandDist(0, ChunkFormat::BAND_COUNT - 1);
+        sf::Time elapsed;
+        std::size_t cells = 0;
+        for (std::size_t done = 0; done < kInstances; done += kChunksPerBatch) {
+            world.clear();
+            // Each chunk spawns above the last, as on the track
+            float spawnY = -200.0f;
+            sf::Clock clock;
+            for (std::size_t i = 0; i < kChunksPerBatch; ++i) {
+                spawnY -= library.instantiate(library.pick(bandDist(rng), rng), world, spawnY);
+            }
+            elapsed += clock.getElapsedTime();
+            cells += world.getObstacles().size() + world.getPowerUps().size() + world.getCoins().size();
+        }
+        const double ns = elapsed.asMicroseconds() * 1000.0;
+        out << std::setw(8) << count << std::setw(10) << std::filesystem::file_size(path) / 1024 << std::setw(10)
+            << loadUs << std::setw(10) << ns / kInstances << std::setw(10) << ns / static_cast<double>(cells) << "\n";
+    }
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+void runLaneGridBenchmark(std::ostream& out) {
+    // Grids as full as a max-speed track gets
+    std::mt19937 rng(1);
+    std::vector<LaneGrid> grids(256);
+    std::uniform_int_distribution<int> laneDist(0, LaneSystem::LANE_COUNT - 1);
+    std::uniform_real_distribution<float> yDist(-4000.0f, 0.0f);
+    for (LaneGrid& grid : grids) {
+        for (int i = 0; i < 16; ++i) {
+            const ObstacleSpec& spec = getObstacleSpec(ObstacleRegistry::pick(rng));
+            grid.addObstacle(laneDist(rng), yDist(rng), spec.height, 1100.0f, spec.clearance);
+        }
+    }
+    const int kPasses = 2000;
+    sf::Clock clock;
+    for (int pass = 0; pass < kPasses; ++pass) {
+        for (const LaneGrid& grid : grids) {
+            gSafeStates = grid.getSafeStates();
+        }
+    }
+    const double ns = clock.getElapsedTime().asMicroseconds() * 1000.0;
+    const double passes = static_cast<double>(kPasses) * grids.size();
+    out << "Reachability pass: " << ns / passes << " ns over a " << LaneGrid::SLOT_COUNT << "-slot horizon ("
+        << ns / (passes * LaneGrid::SLOT_COUNT) << " ns/slot)\n";
+
+    // Built-in layouts, the default chunk library if there is one, and
+    // random chunks that were never checked by hand
+    generateTracks("Built-in layouts", nullptr, out);
+    ChunkLibrary authored;
+    if (authored.load(std::filesystem::path("data") / "chunks.bin")) {
+        generateTracks("Authored chunks", &authored, out);
+    }
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "lane-grid-bench.bin";
+    std::istringstream source(generateChunks(256));
+    std::ostringstream log;
+    if (compileChunkLibrary(source, "generated", path, log)) {
+        ChunkLibrary random;
+        if (random.load(path)) {
+            generateTracks("Random chunks", &random, out);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+
+// Measures the per-frame cost of scrolling, expiring and collision-testing
+// 'entityCount' live obstacles, once as heap-allocated GameObjects reached
+// through virtual calls and once through the EntityWorld tables and systems.
+void runEntityBenchmark(std::size_t entityCount, int frames, std::ostream& out);
+
+// Compiles generated chunk libraries of growing size, maps each one and
+// measures the cost of picking and instantiating a chunk, which should not
+// depend on the library size.
+void runChunkBenchmark(std::ostream& out);
+
+// Times LaneGrid's reachability pass over crowded grids, then generates
+// tracks for a range of seeds and reports how many obstacle spawns the
+// passability check repaired or rejected, and any tick left with no safe
+// lane (there should be none).
+void runLaneGridBenchmark(std::ostream& out);
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+// Stable reference to a world entity. 'index' names a slot in the world's
+// slot array; 'generation' is bumped every time that slot is reclaimed, so a
+// handle kept past its entity's destruction no longer resolves.
+struct EntityHandle {
+    static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    std::uint32_t index = INVALID_INDEX;
+    std::uint32_t generation = 0;
+
+    bool isValid() const { return index != INVALID_INDEX; }
+    bool operator==(const EntityHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
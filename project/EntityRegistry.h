@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <random>
+#include <type_traits>
+
+// Maps a kind enum (ObstacleType, PowerUpType) to its spec struct and says
+// how to describe a concrete type as one. Specialised next to each spec.
+template <typename Kind> struct KindTraits;
+
+// Compile-time list of the concrete types of one kind, e.g.
+//     using ObstacleRegistry = EntityRegistry<Train, Barrier, Cone, Fence>;
+// Builds a constexpr spec table indexed by the kind enum (the world creates
+// rows straight from it, so it doubles as the factory table) and the
+// cumulative spawn weights used by pick(). Registering a new kind means
+// adding its enum value and appending the type to the list.
+template <typename First, typename... Rest> class EntityRegistry {
+public:
+    using Kind = std::decay_t<decltype(First::TYPE)>;
+    using Spec = typename KindTraits<Kind>::Spec;
+
+    static constexpr std::size_t COUNT = 1 + sizeof...(Rest);
+
+    static constexpr std::array<Spec, COUNT> SPECS = { {
+        KindTraits<Kind>::template describe<First>(),
+        KindTraits<Kind>::template describe<Rest>()...
+    } };
+
+    static constexpr const Spec& spec(Kind kind) { return SPECS[static_cast<std::size_t>(kind)]; }
+
+    // Picks a kind with probability proportional to its SPAWN_WEIGHT.
+    template <typename Rng> static Kind pick(Rng& rng) {
+        std::uniform_real_distribution<float> dist(0.0f, CUMULATIVE_WEIGHTS[COUNT - 1]);
+        const float roll = dist(rng);
+        for (std::size_t i = 0; i + 1 < COUNT; ++i) {
+            if (roll < CUMULATIVE_WEIGHTS[i]) {
+                return SPECS[i].type;
+            }
+        }
+        return SPECS[COUNT - 1].type;
+    }
+
+private:
+    static constexpr bool isDense() {
+        for (std::size_t i = 0; i < COUNT; ++i) {
+            if (static_cast<std::size_t>(SPECS[i].type) != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr std::array<float, COUNT> accumulateWeights() {
+        std::array<float, COUNT> sums{};
+        float total = 0.0f;
+        for (std::size_t i = 0; i < COUNT; ++i) {
+            total += SPECS[i].spawnWeight;
+            sums[i] = total;
+        }
+        return sums;
+    }
+
+    static constexpr std::array<float, COUNT> CUMULATIVE_WEIGHTS = accumulateWeights();
+
+    static_assert((std::is_same_v<Kind, std::decay_t<decltype(Rest::TYPE)>> && ...),
+        "EntityRegistry types must all share one kind enum");
+    static_assert(isDense(), "EntityRegistry types must be listed in enum order");
+    static_assert(CUMULATIVE_WEIGHTS[COUNT - 1] > 0.0f, "EntityRegistry needs a positive total spawn weight");
+};
@@ -0,0 +1,165 @@
+#include "EntitySystems.h"
+#include "ConcreteObstacles.h"
+#include "ConcretePowerUps.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+    // Power-ups spawn seconds apart, so only one or two are ever near the
+    // player; more than this takes another broadphase pass.
+    const size_t kMaxNearPowerUps = 16;
+
+    sf::FloatRect hull(const sf::FloatRect& a, const sf::FloatRect& b) {
+        const float left = std::min(a.left, b.left);
+        const float top = std::min(a.top, b.top);
+        return sf::FloatRect(left, top, std::max(a.left + a.width, b.left + b.width) - left,
+            std::max(a.top + a.height, b.top + b.height) - top);
+    }
+
+    // Slab test along one axis: the open time interval during which
+    // [min + t * d, max + t * d] overlaps [fixedMin, fixedMax].
+    bool sweepAxis(float min, float max, float d, float fixedMin, float fixedMax, float& entry, float& exit) {
+        if (d == 0.0f) {
+            if (min >= fixedMax || max <= fixedMin) {
+                return false;
+            }
+            entry = -std::numeric_limits<float>::infinity();
+            exit = std::numeric_limits<float>::infinity();
+            return true;
+        }
+        const float t0 = (fixedMin - max) / d;
+        const float t1 = (fixedMax - min) / d;
+        entry = std::min(t0, t1);
+        exit = std::max(t0, t1);
+        return true;
+    }
+
+    template <typename Table> void scrollTable(Table& table, float dtSeconds, float gameSpeed) {
+        const size_t count = table.size();
+        Position* positions = table.template column<Position>();
+        const Velocity* velocities = table.template column<Velocity>();
+        Render* renders = table.template column<Render>();
+        for (size_t i = 0; i < count; ++i) {
+            positions[i].y += velocities[i].scroll * gameSpeed * dtSeconds;
+            renders[i].rotation += velocities[i].spin * dtSeconds;
+        }
+    }
+}
+
+bool sweepBoxes(const sf::FloatRect& moving, sf::Vector2f delta, const sf::FloatRect& fixed, float& entry,
+    float& exit) {
+    float entryX, exitX, entryY, exitY;
+    if (!sweepAxis(moving.left, moving.left + moving.width, delta.x, fixed.left, fixed.left + fixed.width,
+            entryX, exitX) ||
+        !sweepAxis(moving.top, moving.top + moving.height, delta.y, fixed.top, fixed.top + fixed.height,
+            entryY, exitY)) {
+        return false;
+    }
+    entry = std::max(std::max(entryX, entryY), 0.0f);
+    exit = std::min(exitX, exitY);
+    return entry < exit && entry < 1.0f;
+}
+
+void scrollSystem(EntityWorld& world, float dtSeconds, float gameSpeed) {
+    scrollTable(world.getObstacles(), dtSeconds, gameSpeed);
+    scrollTable(world.getPowerUps(), dtSeconds, gameSpeed);
+    world.getCoins().scroll(gameSpeed * dtSeconds, CoinStore::SPIN_SPEED * dtSeconds);
+    world.advanceTrack(gameSpeed * dtSeconds);
+}
+
+void expireSystem(EntityWorld& world) {
+    world.expireOffscreen();
+    world.collectGarbage();
+}
+
+CollisionReport collideSystem(EntityWorld& world, Player& player) {
+    CollisionReport report;
+    const sf::FloatRect playerBounds = player.getBounds();
+
+    // The player's motion relative to the track over the tick: its own move,
+    // measured at the feet so a slide shrinking the box is not motion, minus
+    // the scroll. 'start' is where the end-of-tick box was at the tick start.
+    const sf::FloatRect previous = player.getPreviousBounds();
+    const sf::Vector2f delta(
+        (playerBounds.left + playerBounds.width / 2.0f) - (previous.left + previous.width / 2.0f),
+        (playerBounds.top + playerBounds.height) - (previous.top + previous.height) - world.getLastAdvance());
+    const sf::FloatRect start(playerBounds.left - delta.x, playerBounds.top - delta.y, playerBounds.width,
+        playerBounds.height);
+    const sf::FloatRect swept = hull(start, playerBounds);
+
+    // Broadphase: the cached boxes near the swept player, tested by the SIMD
+    // overlap kernel. Only its candidates reach the sweep and the per-type
+    // narrow phase. Obstacles are resolved first so a fatal hit wins over a
+    // pickup in the same tick.
+    LaneHit nearPowerUps[kMaxNearPowerUps];
+    size_t nearPowerUpCount = 0;
+    bool morePowerUps = false;
+    auto keepPowerUp = [&](const LaneHit& hit) {
+        if (nearPowerUpCount < kMaxNearPowerUps) {
+            nearPowerUps[nearPowerUpCount++] = hit;
+        }
+        else {
+            morePowerUps = true;
+        }
+    };
+
+    world.forEachOverlap(swept, [&](const LaneHit& hit) {
+        float entry, exit;
+        if (!world.isAlive(hit.handle) || !sweepBoxes(start, delta, hit.box, entry, exit)) {
+            return;
+        }
+        if (hit.archetype == static_cast<std::uint8_t>(Archetype::POWER_UP)) {
+            keepPowerUp(hit);
+            return;
+        }
+        // The rules compare the player's box with the obstacle's. Shifting the
+        // obstacle by the motion still to come recreates the moment of
+        // contact against the end-of-tick player. Contact at the very start
+        // was already judged last tick; if they still overlap at the end,
+        // that moment is judged too.
+        const ObstacleSpec& spec = getObstacleSpec(static_cast<ObstacleType>(hit.kind));
+        float impact = entry;
+        bool fatal = entry > 0.0f &&
+            spec.onCollision(player, sf::FloatRect(hit.box.left + (1.0f - entry) * delta.x,
+                hit.box.top + (1.0f - entry) * delta.y, hit.box.width, hit.box.height));
+        if (!fatal && exit >= 1.0f) {
+            impact = 1.0f;
+            fatal = spec.onCollision(player, hit.box);
+        }
+        if (fatal && (!report.fatal || impact < report.impactTime)) {
+            report.fatal = true;
+            report.cause = spec.type;
+            report.impactTime = impact;
+        }
+    });
+    if (report.fatal) {
+        return report;
+    }
+
+    // Check Coins (pickups are harmless, so the swept hull is close enough)
+    report.coins = world.getCoins().collect(swept);
+
+    // Check PowerUps
+    for (;;) {
+        for (size_t i = 0; i < nearPowerUpCount; ++i) {
+            getPowerUpSpec(static_cast<PowerUpType>(nearPowerUps[i].kind)).applyEffect(player);
+            // Gone from every system immediately; the slot is reclaimed next tick.
+            world.destroy(nearPowerUps[i].handle);
+            report.powerUps++;
+        }
+        if (!morePowerUps) {
+            break;
+        }
+        // More than the buffer holds: pick up the rest, skipping those applied
+        nearPowerUpCount = 0;
+        morePowerUps = false;
+        world.forEachOverlap(swept, [&](const LaneHit& hit) {
+            float entry, exit;
+            if (hit.archetype == static_cast<std::uint8_t>(Archetype::POWER_UP) && world.isAlive(hit.handle) &&
+                sweepBoxes(start, delta, hit.box, entry, exit)) {
+                keepPowerUp(hit);
+            }
+        });
+    }
+    return report;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "EntityWorld.h"
+#include "Player.h"
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+// Systems operating on the EntityWorld tables. Each one walks the columns it
+// needs linearly; none of them go through per-entity virtual calls. Drawing
+// lives in WorldRenderer so these stay free of any window dependency.
+
+struct CollisionReport {
+    bool fatal = false;
+    ObstacleType cause = ObstacleType::TRAIN; // only meaningful when fatal
+    float impactTime = 1.0f; // fraction of the tick at which the fatal hit happened
+    int coins = 0;
+    int powerUps = 0;
+};
+
+inline sf::FloatRect getBounds(const Position& position, const Extent& extent) {
+    return sf::FloatRect(position.x + extent.left, position.y + extent.top,
+        extent.right - extent.left, extent.bottom - extent.top);
+}
+
+// Continuous AABB test: 'moving' travels by 'delta' over the tick while
+// 'fixed' stays put. Returns true if they overlap (strict edges, like
+// sf::FloatRect::intersects) at some point of the tick; entry and exit are
+// the tick fractions at which the overlap starts and ends (entry >= 0, exit
+// may be past 1).
+bool sweepBoxes(const sf::FloatRect& moving, sf::Vector2f delta, const sf::FloatRect& fixed, float& entry,
+    float& exit);
+
+// Moves everything down the track and advances spin.
+void scrollSystem(EntityWorld& world, float dtSeconds, float gameSpeed);
+
+// The once-per-tick cleanup: expires whatever scrolled off the lane fronts,
+// then drops destroyed entities and recycles their handle slots.
+void expireSystem(EntityWorld& world);
+
+// Tests the player against the cached obstacle and power-up boxes in its
+// lanes (SIMD broadphase, then the per-type rules) and against the coins.
+// The tests are swept over the player's motion relative to the track during
+// the last tick, so a long tick cannot step over an obstacle. Reports the
+// earliest fatal obstacle; otherwise collects coins and applies (and
+// consumes) touched power-ups.
+CollisionReport collideSystem(EntityWorld& world, Player& player);
@@ -0,0 +1,250 @@
+#include "EntityWorld.h"
+#include "ConcreteObstacles.h"
+#include "ConcretePowerUps.h"
+#include <algorithm>
+
+namespace {
+    const float kPowerUpSpin = 90.0f; // degrees per second
+
+    sf::FloatRect boxOf(const Position& position, const Extent& extent) {
+        return sf::FloatRect(position.x + extent.left, position.y + extent.top,
+            extent.right - extent.left, extent.bottom - extent.top);
+    }
+}
+
+void EntityWorld::reserve(size_t obstacles, size_t powerUps, size_t coins) {
+    mObstacles.reserve(obstacles);
+    mPowerUps.reserve(powerUps);
+    mCoins.reserve(coins);
+    mSlots.reserve(obstacles + powerUps + coins);
+    mFreeSlots.reserve(obstacles + powerUps + coins);
+    mPendingRemoval.reserve(obstacles + powerUps);
+    // Destroyed entries stay in a lane until they scroll off, so size each
+    // lane for everything on the track rather than a third of it.
+    mLanes.reserve(obstacles + powerUps);
+}
+
+void EntityWorld::clear() {
+    mObstacles.clear();
+    mPowerUps.clear();
+    mCoins.clear();
+    mPendingRemoval.clear();
+    mLanes.clear();
+    mLastAdvance = 0.0f;
+    // Invalidate every outstanding handle but keep the slots for reuse.
+    mFreeSlots.clear();
+    for (size_t i = mSlots.size(); i-- > 0;) {
+        if (mSlots[i].row != EntityHandle::INVALID_INDEX) {
+            mSlots[i].generation++; // slot was in use; free slots were bumped on release
+        }
+        mSlots[i].alive = false;
+        mSlots[i].row = EntityHandle::INVALID_INDEX;
+        mFreeSlots.push_back(static_cast<std::uint32_t>(i));
+    }
+}
+
+EntityHandle EntityWorld::spawnObstacle(ObstacleType type, float x, float y) {
+    const ObstacleSpec& spec = getObstacleSpec(type);
+    // Origin at bottom center
+    Extent extent{ -spec.width / 2.0f, -spec.height, spec.width / 2.0f, 0.0f };
+    Render render{ static_cast<SpriteId>(static_cast<int>(SpriteId::TRAIN) + static_cast<int>(type)), 0.0f };
+    countSpawn(mObstacles.size() == mObstacles.capacity() || mLanes.isFull(LaneSystem::getLaneIndex(x)));
+    EntityHandle handle = allocate(Archetype::OBSTACLE, mObstacles.size());
+    mObstacles.add(Position{ x, y }, Velocity{ 1.0f, 0.0f }, extent, render, ObstacleBehaviour{ type },
+        Status{ false }, handle);
+    track(handle, Archetype::OBSTACLE, static_cast<std::uint8_t>(type), Position{ x, y }, extent);
+    return handle;
+}
+
+EntityHandle EntityWorld::spawnPowerUp(PowerUpType type, float x, float y) {
+    const PowerUpSpec& spec = getPowerUpSpec(type);
+    Extent extent{ -spec.radius, -spec.radius, spec.radius, spec.radius };
+    Render render{ static_cast<SpriteId>(static_cast<int>(SpriteId::MAGNET) + static_cast<int>(type)), 0.0f };
+    countSpawn(mPowerUps.size() == mPowerUps.capacity() || mLanes.isFull(LaneSystem::getLaneIndex(x)));
+    EntityHandle handle = allocate(Archetype::POWER_UP, mPowerUps.size());
+    mPowerUps.add(Position{ x, y }, Velocity{ 1.0f, kPowerUpSpin }, extent, render, PowerUpBehaviour{ type },
+        Status{ false }, handle);
+    track(handle, Archetype::POWER_UP, static_cast<std::uint8_t>(type), Position{ x, y }, extent);
+    return handle;
+}
+
+EntityHandle EntityWorld::spawnCoin(float x, float y) {
+    countSpawn(mCoins.size() == mCoins.capacity());
+    EntityHandle handle = allocate(Archetype::COIN, mCoins.size());
+    mCoins.spawn(x, y, handle);
+    return handle;
+}
+
+bool EntityWorld::isAlive(EntityHandle handle) const {
+    const Slot* slot = find(handle);
+    if (!slot || !slot->alive) {
+        return false;
+    }
+    // The pickup kernel kills coins in bulk without going through destroy().
+    return slot->archetype != Archetype::COIN || mCoins.isAlive(slot->row);
+}
+
+bool EntityWorld::destroy(EntityHandle handle) {
+    if (!isAlive(handle)) {
+        mStaleHandles++;
+        return false;
+    }
+    const Slot* slot = &mSlots[handle.index];
+    mSlots[handle.index].alive = false;
+    switch (slot->archetype) {
+    case Archetype::OBSTACLE:
+        mObstacles.get<Status>(slot->row).dead = true;
+        mPendingRemoval.push_back(handle);
+        break;
+    case Archetype::POWER_UP:
+        mPowerUps.get<Status>(slot->row).dead = true;
+        mPendingRemoval.push_back(handle);
+        break;
+    case Archetype::COIN:
+        mCoins.kill(slot->row);
+        break;
+    }
+    return true;
+}
+
+bool EntityWorld::resolve(EntityHandle handle, Archetype& archetype, size_t& row) const {
+    if (!isAlive(handle)) {
+        return false;
+    }
+    const Slot* slot = &mSlots[handle.index];
+    archetype = slot->archetype;
+    row = slot->row;
+    return true;
+}
+
+void EntityWorld::expireOffscreen() {
+    mLanes.expire(DESPAWN_Y, [this](EntityHandle handle) {
+        if (isAlive(handle)) {
+            destroy(handle);
+        }
+    });
+}
+
+void EntityWorld::collectGarbage() {
+    // Table rows: only the ones destroy() queued, not a scan of every row.
+    for (EntityHandle handle : mPendingRemoval) {
+        const Slot& slot = mSlots[handle.index];
+        if (slot.archetype == Archetype::OBSTACLE) {
+            removeRow(mObstacles, slot.row);
+        }
+        else {
+            removeRow(mPowerUps, slot.row);
+        }
+        release(handle);
+    }
+    mPendingRemoval.clear();
+
+    mCoins.compact([this](EntityHandle handle) { release(handle); },
+        [this](EntityHandle handle, size_t row) { mSlots[handle.index].row = static_cast<std::uint32_t>(row); });
+}
+
+template <typename Table> void EntityWorld::removeRow(Table& table, size_t row) {
+    table.removeRowUnordered(row);
+    if (row < table.size()) {
+        EntityHandle moved = table.template get<EntityHandle>(row);
+        mSlots[moved.index].row = static_cast<std::uint32_t>(row);
+    }
+}
+
+void EntityWorld::track(EntityHandle handle, Archetype archetype, std::uint8_t kind, const Position& position,
+    const Extent& extent) {
+    mLanes.insert(LaneSystem::getLaneIndex(position.x), handle, static_cast<std::uint8_t>(archetype), kind,
+        position.y, boxOf(position, extent));
+    mReachAbove = std::max(mReachAbove, -extent.top);
+    mReachBelow = std::max(mReachBelow, extent.bottom);
+}
+
+void EntityWorld::countSpawn(bool storageFull) {
+    if (storageFull || (mFreeSlots.empty() && mSlots.size() == mSlots.capacity())) {
+        mPoolStats.misses++;
+    }
+    else {
+        mPoolStats.hits++;
+    }
+}
+
+EntityHandle EntityWorld::allocate(Archetype archetype, size_t row) {
+    std::uint32_t index;
+    if (!mFreeSlots.empty()) {
+        index = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+    else {
+        index = static_cast<std::uint32_t>(mSlots.size());
+        mSlots.push_back(Slot{ 0, 0, archetype, false });
+    }
+    Slot& slot = mSlots[index];
+    slot.row = static_cast<std::uint32_t>(row);
+    slot.archetype = archetype;
+    slot.alive = true;
+
+    EntityHandle handle;
+    handle.index = index;
+    handle.generation = slot.generation;
+    return handle;
+}
+
+void EntityWorld::release(EntityHandle handle) {
+    Slot& slot = mSlots[handle.index];
+    slot.generation++;
+    slot.alive = false;
+    slot.row = EntityHandle::INVALID_INDEX;
+    mFreeSlots.push_back(handle.index);
+}
+
+const EntityWorld::Slot* EntityWorld::find(EntityHandle handle) const {
+    if (handle.index >= mSlots.size()) {
+        return nullptr;
+    }
+    const Slot& slot = mSlots[handle.index];
+    return slot.generation == handle.generation ? &slot : nullptr;
+}
+
+void EntityWorld::saveState(SnapshotWriter& writer) const {
+    mObstacles.saveState(writer);
+    mPowerUps.saveState(writer);
+    mCoins.saveState(writer);
+    writer.values(mSlots);
+    writer.values(mFreeSlots);
+    writer.values(mPendingRemoval);
+    mLanes.saveState(writer);
+    writer.value(mReachAbove);
+    writer.value(mReachBelow);
+    writer.value(mLastAdvance);
+    writer.value<std::uint64_t>(mStaleHandles);
+}
+
+bool EntityWorld::loadState(SnapshotReader& reader) {
+    std::uint64_t staleHandles = 0;
+    if (!mObstacles.loadState(reader) || !mPowerUps.loadState(reader) || !mCoins.loadState(reader) ||
+        !reader.values(mSlots) || !reader.values(mFreeSlots) || !reader.values(mPendingRemoval) ||
+        !mLanes.loadState(reader) || !reader.value(mReachAbove) || !reader.value(mReachBelow) ||
+        !reader.value(mLastAdvance) || !reader.value(staleHandles)) {
+        return false;
+    }
+    mStaleHandles = static_cast<size_t>(staleHandles);
+    // Handles are used as indices, so check they all land inside the slots
+    for (const Slot& slot : mSlots) {
+        const size_t rows = slot.archetype == Archetype::OBSTACLE ? mObstacles.size()
+            : slot.archetype == Archetype::POWER_UP ? mPowerUps.size() : mCoins.size();
+        if (slot.row != EntityHandle::INVALID_INDEX && slot.row >= rows) {
+            return false;
+        }
+    }
+    for (std::uint32_t index : mFreeSlots) {
+        if (index >= mSlots.size()) {
+            return false;
+        }
+    }
+    for (EntityHandle handle : mPendingRemoval) {
+        if (handle.index >= mSlots.size()) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include "ArchetypeTable.h"
+#include "CoinStore.h"
+#include "Components.h"
+#include "EntityHandle.h"
+#include "LaneIndex.h"
+#include "LaneSystem.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class Archetype : std::uint8_t { OBSTACLE, POWER_UP, COIN };
+
+// Spawns served from the storage reserved up front (hits) and spawns that
+// had to grow a table, the slot array or a lane ring (misses).
+struct EntityPoolStats {
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+// Owns every live track entity, grouped by archetype. Obstacles and power-ups
+// are rows in dense component tables; coins keep the specialised
+// structure-of-arrays table from CoinStore. Behaviour lives in the systems
+// (EntitySystems.h) that iterate these tables, not in the entities.
+//
+// Entities are referred to by generational handles. destroy() only marks an
+// entity dead; collectGarbage() is the single pass per tick that drops dead
+// rows and recycles their slots. Storage is a pool prewarmed by reserve()
+// (TrackCapacityConfig for the game's tracks): rows and slots are reused
+// from then on, and getPoolStats() counts any spawn that had to grow it.
+//
+// Obstacles and power-ups never leave their lane and scroll with the track,
+// so they are also kept in a LaneIndex together with a cached copy of their
+// boxes: expiry pops them off the lane fronts, and overlap queries sweep only
+// the lanes and y-range around the query box.
+// Coins are left out because the magnet pulls them across lanes; they stay on
+// the CoinStore's vectorised sweeps.
+class EntityWorld {
+public:
+    using ObstacleTable = ArchetypeTable<Position, Velocity, Extent, Render, ObstacleBehaviour, Status, EntityHandle>;
+    using PowerUpTable = ArchetypeTable<Position, Velocity, Extent, Render, PowerUpBehaviour, Status, EntityHandle>;
+
+    static constexpr float DESPAWN_Y = 800.0f; // Screen height + buffer
+
+    void reserve(size_t obstacles, size_t powerUps, size_t coins);
+    void clear();
+
+    EntityHandle spawnObstacle(ObstacleType type, float x, float y);
+    EntityHandle spawnPowerUp(PowerUpType type, float x, float y);
+    EntityHandle spawnCoin(float x, float y);
+
+    // Tells the lane index the track moved down by 'dy'. Lane-indexed rows
+    // must scroll by exactly this much (Velocity::scroll == 1).
+    void advanceTrack(float dy) {
+        mLanes.advance(dy);
+        mLastAdvance = dy;
+    }
+
+    // How far the track moved in the last tick; collisions sweep across it.
+    float getLastAdvance() const { return mLastAdvance; }
+
+    // Destroys lane-indexed entities that scrolled past DESPAWN_Y.
+    void expireOffscreen();
+
+    // Calls visit(const LaneHit&) for every cached obstacle or power-up box
+    // overlapping 'box'. Only the lanes under the box and anchors within
+    // reach of it are swept. Destroyed entities that have not scrolled off
+    // yet are still visited; check isAlive(hit.handle).
+    template <typename Visit> void forEachOverlap(const sf::FloatRect& box, Visit visit) const {
+        const float halfLane = LaneSystem::LANE_WIDTH / 2.0f;
+        const float right = box.left + box.width;
+        const float bottom = box.top + box.height;
+        for (int lane = 0; lane < LaneSystem::LANE_COUNT; ++lane) {
+            const float center = LaneSystem::getLaneCenter(lane);
+            if (center + halfLane < box.left || center - halfLane > right) {
+                continue;
+            }
+            mLanes.forEachOverlap(lane, box.top - mReachBelow, bottom + mReachAbove, box, visit);
+        }
+    }
+
+    // Calls visit(const LaneHit&) for every lane-indexed entry (debug drawing).
+    template <typename Visit> void forEachIndexed(Visit visit) const { mLanes.forEach(visit); }
+
+    // True while the handle's entity exists and has not been destroyed.
+    bool isAlive(EntityHandle handle) const;
+
+    // Marks the entity dead. Returns false (and counts it) for stale handles.
+    bool destroy(EntityHandle handle);
+
+    // Looks up where a live entity currently sits. Rows move during
+    // collectGarbage(), so do not hold on to the result across ticks.
+    bool resolve(EntityHandle handle, Archetype& archetype, size_t& row) const;
+
+    // Drops destroyed and off-screen entities and reclaims their slots.
+    void collectGarbage();
+
+    ObstacleTable& getObstacles() { return mObstacles; }
+    const ObstacleTable& getObstacles() const { return mObstacles; }
+    PowerUpTable& getPowerUps() { return mPowerUps; }
+    const PowerUpTable& getPowerUps() const { return mPowerUps; }
+    CoinStore& getCoins() { return mCoins; }
+    const CoinStore& getCoins() const { return mCoins; }
+
+    size_t getEntityCount() const { return mObstacles.size() + mPowerUps.size() + mCoins.size(); }
+    size_t getEntityCapacity() const { return mObstacles.capacity() + mPowerUps.capacity() + mCoins.capacity(); }
+    size_t getStaleHandleCount() const { return mStaleHandles; }
+    const EntityPoolStats& getPoolStats() const { return mPoolStats; }
+    size_t getLaneIndexSize() const { return mLanes.size(); }
+
+    // Tables, handle slots and lane index exactly as they are, so a restored
+    // world iterates in the same order and keeps every handle valid.
+    void saveState(SnapshotWriter& writer) const;
+    bool loadState(SnapshotReader& reader);
+
+private:
+    struct Slot {
+        std::uint32_t generation;
+        std::uint32_t row;
+        Archetype archetype;
+        bool alive;
+    };
+
+    void countSpawn(bool storageFull);
+    EntityHandle allocate(Archetype archetype, size_t row);
+    void release(EntityHandle handle);
+    const Slot* find(EntityHandle handle) const;
+    void track(EntityHandle handle, Archetype archetype, std::uint8_t kind, const Position& position,
+        const Extent& extent);
+    template <typename Table> void removeRow(Table& table, size_t row);
+
+    ObstacleTable mObstacles;
+    PowerUpTable mPowerUps;
+    CoinStore mCoins;
+
+    std::vector<Slot> mSlots;
+    std::vector<std::uint32_t> mFreeSlots;
+    std::vector<EntityHandle> mPendingRemoval; // destroyed table rows awaiting collectGarbage()
+
+    LaneIndex mLanes;
+    float mReachAbove = 0.0f; // furthest any indexed box extends above its anchor
+    float mReachBelow = 0.0f; // ... and below it
+    float mLastAdvance = 0.0f;
+    size_t mStaleHandles = 0;
+    EntityPoolStats mPoolStats; // diagnostics, not part of the saved state
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+// Bump allocator for data that only lives for one frame. allocate() is a
+// pointer increment; nothing is freed individually. reset() at the top of the
+// frame rewinds the whole arena at once.
+//
+// If a frame needs more than the arena holds, the overflow is served from the
+// heap and the arena grows to fit on the next reset(), so the steady state
+// stays inside the single buffer.
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t capacity = 64 * 1024)
+        : mBuffer(static_cast<char*>(::operator new(capacity))), mCapacity(capacity), mUsed(0),
+        mHighWater(0), mOverflow(nullptr), mOverflowCount(0) {
+    }
+
+    ~FrameArena() {
+        releaseOverflow();
+        ::operator delete(mBuffer);
+    }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+        std::size_t start = (mUsed + alignment - 1) & ~(alignment - 1);
+        if (start + bytes <= mCapacity) {
+            mUsed = start + bytes;
+            if (mUsed > mHighWater) {
+                mHighWater = mUsed;
+            }
+            return mBuffer + start;
+        }
+        return allocateOverflow(bytes, alignment);
+    }
+
+    void reset() {
+        if (mOverflow) {
+            // Grow once, outside the frame, so the next frames fit.
+            std::size_t needed = mHighWater * 2;
+            releaseOverflow();
+            ::operator delete(mBuffer);
+            mBuffer = static_cast<char*>(::operator new(needed));
+            mCapacity = needed;
+        }
+        mUsed = 0;
+    }
+
+    std::size_t getUsed() const { return mUsed; }
+    std::size_t getCapacity() const { return mCapacity; }
+    std::size_t getHighWater() const { return mHighWater; }
+    std::size_t getOverflowCount() const { return mOverflowCount; }
+
+private:
+    struct OverflowBlock {
+        OverflowBlock* next;
+    };
+
+    void* allocateOverflow(std::size_t bytes, std::size_t alignment) {
+        std::size_t header = (sizeof(OverflowBlock) + alignment - 1) & ~(alignment - 1);
+        char* raw = static_cast<char*>(::operator new(header + bytes));
+        OverflowBlock* block = reinterpret_cast<OverflowBlock*>(raw);
+        block->next = mOverflow;
+        mOverflow = block;
+        mOverflowCount++;
+        mHighWater += bytes + alignment;
+        return raw + header;
+    }
+
+    void releaseOverflow() {
+        while (mOverflow) {
+            OverflowBlock* next = mOverflow->next;
+            ::operator delete(mOverflow);
+            mOverflow = next;
+        }
+    }
+
+    char* mBuffer;
+    std::size_t mCapacity;
+    std::size_t mUsed;
+    std::size_t mHighWater;
+    OverflowBlock* mOverflow;
+    std::size_t mOverflowCount;
+};
+
+// Standard allocator adapter so STL containers can live in a FrameArena.
+// deallocate() is a no-op; memory comes back when the arena is reset.
+template <typename T> class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena& arena) : mArena(&arena) {}
+    template <typename U> ArenaAllocator(const ArenaAllocator<U>& other) : mArena(other.getArena()) {}
+
+    T* allocate(std::size_t count) { return static_cast<T*>(mArena->allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, std::size_t) {}
+
+    FrameArena* getArena() const { return mArena; }
+
+    template <typename U> bool operator==(const ArenaAllocator<U>& other) const { return mArena == other.getArena(); }
+    template <typename U> bool operator!=(const ArenaAllocator<U>& other) const { return mArena != other.getArena(); }
+
+private:
+    FrameArena* mArena;
+};
+
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+template <typename T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
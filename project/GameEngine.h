@@ -1,74 +1,150 @@
-#pragma once
-#include "Player.h"
-#include "ScoreManager.h"
-#include "TrackManager.h"
-#include "Obstacle.h" 
-#include <SFML/Graphics.hpp>
-#include <SFML/Audio.hpp>
-#include <memory>
-
-
-class GameEngine {
-public:
-    GameEngine();
-    void run();
-
-private:
-    enum class MenuItem { Play = 0, Highscore = 1 };
-
-    void processEvents();
-    void update(sf::Time deltaTime);
-    void render();
-    void handleCollisions();
-    void resetGame(const std::string& playerName = "Player"); 
-    
-    void loadMenuResources();       
-    void loadAllGameResources();    
-    
-    void updatePauseSprite();
-    void updateMenuVisualState();
-    void refreshHighscoreText();
-
-    sf::RenderWindow mWindow;
-    std::unique_ptr<Player> mPlayer;
-    std::unique_ptr<TrackManager> mTrackManager;
-    std::unique_ptr<ScoreManager> mScoreManager;
-
-    sf::Font mFont;
-    sf::Text mScoreText;
-    sf::Text mGameOverText;
-    sf::Sound mBgMusic;
-    sf::Sprite mBackgroundSprite;
-    sf::Sprite mHudBannerSprite;
-    sf::Sprite mCoinIcon;
-    sf::Sprite mPauseSprite;
-    sf::Sprite mGameOverSprite;
-    sf::Sprite mMenuSprite;
-
-    sf::RectangleShape mHudPanel;
-    sf::RectangleShape mMenuPanel;
-    sf::Text mMenuOptions[2];
-    sf::Text mMenuHintText;
-    sf::Text mHighscoreText;
-
-    // --- Registration UI Elements ---
-    sf::RectangleShape mRegPanel;
-    sf::RectangleShape mRegInputBox;
-    sf::Text mRegPromptText;
-    sf::Text mRegInputText;
-    sf::String mPlayerNameInput; // Stores the input text
-    // --------------------------------
-
-    bool mIsPaused;
-    bool mIsGameOver;
-    bool mShowMenu;
-    bool mShowHighscorePanel;
-    MenuItem mMenuSelection;
-    
-    // Reordered to match initialization in GameEngine.cpp
-    bool mAreGameAssetsLoaded = false;
-    bool mIsDebugMode = false; 
-    bool mShowRegistration = false; 
-    
-    float mDayNightTimer;
+#pragma once
+#include "Autopilot.h"
+#include "FrameArena.h"
+#include "LeaderboardService.h"
+#include "RewindBuffer.h"
+#include "Simulation.h"
+#include "Spectator.h"
+#include "WorldRenderer.h"
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include <filesystem>
+#include <memory>
+
+
+struct GameConfig {
+    // The simulation always advances in fixed ticks of 1 / tickRate seconds,
+    // whatever the display refresh rate.
+    unsigned int tickRate = 60;
+    // Each run's inputs are saved here as a Replay when it ends (empty = off).
+    std::filesystem::path recordPath;
+    // Non-zero: publish every tick to SpectatorServer subscribers. Only
+    // screens on this machine can subscribe unless spectateAddress is widened
+    // (e.g. to sf::IpAddress::Any) on purpose.
+    unsigned short spectatePort = 0;
+    sf::IpAddress spectateAddress = sf::IpAddress::LocalHost;
+    // The running game is snapshotted here every few seconds and on quit,
+    // and resumed from it on the next start (empty = off).
+    std::filesystem::path snapshotPath = std::filesystem::path("data") / "session.snap";
+    // Non-empty: also send results to the leaderboard daemon and show its
+    // global standings in the highscore panel.
+    std::string leaderboardHost;
+    unsigned short leaderboardPort = LeaderboardProtocol::DEFAULT_PORT;
+    // Practice mode: the last seconds of the run stay in a RewindBuffer and
+    // Backspace steps back through them, also from the game-over screen.
+    // Practice runs are not logged or sent to the leaderboard.
+    bool practice = false;
+    // Start runs with the built-in Autopilot playing (B toggles it in game).
+    bool autopilot = false;
+    // Compiled track chunks (see ChunkLibrary), mapped at startup. A missing
+    // file leaves the built-in obstacle layouts.
+    std::filesystem::path chunkPath = std::filesystem::path("data") / "chunks.bin";
+};
+
+class GameEngine {
+public:
+    static constexpr unsigned int DEFAULT_TICK_RATE = 60;
+
+    explicit GameEngine(const GameConfig& config = GameConfig());
+    void run();
+
+private:
+    enum class MenuItem { Play = 0, Highscore = 1 };
+
+    void processEvents();
+    void update(sf::Time deltaTime);
+    void updateHud();
+    void render();
+    void finishRun();
+    bool runCounts() const { return !mRewind && !mAutopilotPlayed; }
+    void flushHighScore();
+    void saveReplay();
+    void saveSnapshot();
+    bool restoreSnapshot(const GameConfig& config);
+    void discardSnapshot();
+    void rewindRun();
+    void resetGame(const std::string& playerName = "Player"); 
+    
+    void loadMenuResources();       
+    void loadAllGameResources();    
+    
+    void updatePauseSprite();
+    void updateMenuVisualState();
+    void refreshHighscoreText();
+
+    sf::RenderWindow mWindow;
+    ChunkLibrary mChunks; // shared by every run, so it outlives them
+    std::unique_ptr<Simulation> mSimulation; // the current run
+    WorldRenderer mWorldRenderer;
+
+    sf::Font mFont;
+    sf::Text mScoreText;
+    sf::Text mGameOverText;
+    sf::Sound mBgMusic;
+    sf::Sprite mBackgroundSprite;
+    sf::Sprite mHudBannerSprite;
+    sf::Sprite mCoinIcon;
+    sf::Sprite mPauseSprite;
+    sf::Sprite mGameOverSprite;
+    sf::Sprite mMenuSprite;
+
+    // Scratch memory for data that only lives for one frame (HUD text, debug
+    // geometry). Reset at the top of every loop iteration.
+    FrameArena mFrameArena;
+    std::string mHudText; // last string handed to mScoreText
+
+    sf::RectangleShape mGroundShape;
+    sf::RectangleShape mLaneLine;
+    sf::RectangleShape mHudPanel;
+    sf::RectangleShape mMenuPanel;
+    sf::Text mMenuOptions[2];
+    sf::Text mMenuHintText;
+    sf::Text mHighscoreText;
+
+    // --- Registration UI Elements ---
+    sf::RectangleShape mRegPanel;
+    sf::RectangleShape mRegInputBox;
+    sf::Text mRegPromptText;
+    sf::Text mRegInputText;
+    sf::String mPlayerNameInput; // Stores the input text
+    // --------------------------------
+
+    bool mIsPaused;
+    bool mIsGameOver;
+    bool mShowMenu;
+    bool mShowHighscorePanel;
+    MenuItem mMenuSelection;
+    
+    // Reordered to match initialization in GameEngine.cpp
+    bool mAreGameAssetsLoaded = false;
+    bool mIsDebugMode = false; 
+    bool mShowRegistration = false; 
+    
+    float mDayNightTimer;
+    float mHighScoreFlushTimer = 0.0f;
+
+    // Fixed-step loop state
+    unsigned int mTickRate;
+    sf::Time mTickTime;
+    sf::Time mTickAccumulator; // simulation time owed to the loop
+    float mRenderAlpha = 1.0f; // position of the rendered frame between the last two ticks
+
+    std::filesystem::path mRecordPath; // empty = do not save replays
+    SpectatorServer mSpectators;
+
+    // Crash recovery: the run is snapshotted every SNAPSHOT_INTERVAL seconds
+    std::filesystem::path mSnapshotPath;
+    std::vector<std::uint8_t> mSnapshotBuffer; // reused between saves
+    float mSnapshotTimer = 0.0f;
+    sf::Int64 mSnapshotSaveMicros = -1; // last serialize time (-1 = none yet)
+    sf::Int64 mSnapshotWriteMicros = -1; // ... and file write time
+    sf::Int64 mSnapshotRestoreMicros = -1; // startup restore time
+    std::unique_ptr<RewindBuffer> mRewind; // null unless in practice mode
+    Autopilot mAutopilot;
+    bool mAutopilotOn = false;
+    bool mAutopilotPlayed = false; // the bot pressed keys in this run
+    std::unique_ptr<LeaderboardClient> mLeaderboard; // null = local scores only
+    LeaderboardStanding mStanding; // last answer from the daemon
+    bool mHasSubmitted = false; // mStanding.rank is for a finished run
+    unsigned int mSteadyFrames = 0; // consecutive gameplay frames since the last state change
 };
\ No newline at end of file
@@ -0,0 +1,618 @@
+#include "HeadlessRunner.h"
+#include "AllocationTracker.h"
+#include "Autopilot.h"
+#include "ConcreteObstacles.h"
+#include "InputPolicy.h"
+#include "Replay.h"
+#include "RewindBuffer.h"
+#include "Simulation.h"
+#include "SpectatorStream.h"
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+    // Fixed so two headless runs of the same build press the same keys.
+    const unsigned int kInputSeed = 12345;
+
+    std::unique_ptr<Simulation> newRun(unsigned int tickRate, std::mt19937& rng,
+        const ChunkLibrary* chunks = nullptr) {
+        SimulationConfig config;
+        config.seed = static_cast<unsigned int>(rng());
+        config.tickRate = tickRate;
+        config.chunks = chunks;
+        config.loadStoredScores = false;
+        return std::make_unique<Simulation>(config);
+    }
+
+    // Hands 'bytes' to 'view' in pieces of 'chunk' bytes, the way a socket might.
+    bool feedInChunks(SpectatorView& view, const std::vector<std::uint8_t>& bytes, std::size_t chunk) {
+        bool ok = true;
+        for (std::size_t offset = 0; offset < bytes.size(); offset += chunk) {
+            ok = view.feed(bytes.data() + offset, std::min(chunk, bytes.size() - offset)) && ok;
+        }
+        return ok;
+    }
+
+    // Compares what a spectator rebuilt with the simulation it mirrors.
+    // Obstacles and power-ups must sit within a pixel of the real ones;
+    // coins are only counted, since the magnet moves them off the track.
+    bool matches(const SpectatorView& view, const Simulation& simulation, std::vector<float>& expected,
+        std::vector<float>& actual) {
+        const Player& player = simulation.getPlayer();
+        if (!view.isSynced() || view.getTick() != simulation.getTickCount() ||
+            view.getPlayerLane() != player.getLane() || view.getPlayerState() != static_cast<int>(player.getState()) ||
+            std::abs(view.getPlayerY() - player.getPosition().y) > 0.5f ||
+            view.getScore() != static_cast<std::int64_t>(simulation.getScore().getScore()) ||
+            view.getCoins() != simulation.getScore().getCoins()) {
+            return false;
+        }
+
+        const EntityWorld& world = simulation.getTrack().getWorld();
+        expected.clear();
+        actual.clear();
+        std::size_t coins = 0;
+        for (size_t i = 0; i < world.getObstacles().size(); ++i) {
+            if (!world.getObstacles().get<Status>(i).dead) {
+                expected.push_back(world.getObstacles().get<Position>(i).y);
+            }
+        }
+        for (size_t i = 0; i < world.getPowerUps().size(); ++i) {
+            if (!world.getPowerUps().get<Status>(i).dead) {
+                expected.push_back(world.getPowerUps().get<Position>(i).y);
+            }
+        }
+        for (size_t i = 0; i < world.getCoins().size(); ++i) {
+            coins += world.getCoins().isAlive(i) && world.getCoins().getPosition(i).y <= CoinStore::DESPAWN_Y;
+        }
+        for (const SpectatorView::Entity& entity : view.getEntities()) {
+            if (entity.archetype == Archetype::COIN) {
+                coins--;
+            }
+            else {
+                actual.push_back(view.getEntityY(entity));
+            }
+        }
+        if (coins != 0 || expected.size() != actual.size()) {
+            return false;
+        }
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            if (std::abs(expected[i] - actual[i]) > 1.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void runHeadless(std::uint64_t ticks, unsigned int tickRate, const ChunkLibrary* chunks, std::ostream& out,
+    const std::filesystem::path& recordPath) {
+    tickRate = tickRate > 0 ? tickRate : 60;
+    std::mt19937 rng(kInputSeed);
+
+    auto simulation = newRun(tickRate, rng, chunks);
+    std::uint64_t runs = 0;
+    double totalScore = 0.0;
+    float bestScore = -1.0f;
+    Replay bestReplay;
+
+    sf::Clock clock;
+    for (std::uint64_t tick = 0; tick < ticks; ++tick) {
+        randomInput(*simulation, rng);
+        simulation->step();
+        if (simulation->isOver()) {
+            const float score = simulation->getScore().getScore();
+            totalScore += score;
+            if (score > bestScore) {
+                bestScore = score;
+                bestReplay = simulation->getReplay();
+                bestReplay.setChecksum(simulation->getChecksum());
+            }
+            runs++;
+            simulation = newRun(tickRate, rng, chunks);
+        }
+    }
+    const float wallSeconds = clock.getElapsedTime().asSeconds();
+    const float tickSeconds = simulation->getTickTime().asSeconds();
+
+    out << "Ticks: " << ticks << " at " << tickRate << " Hz (" << ticks * tickSeconds << " s simulated)\n"
+        << "Wall time: " << wallSeconds << " s";
+    if (wallSeconds > 0.0f) {
+        out << ", " << static_cast<double>(ticks) / wallSeconds << " ticks/s";
+    }
+    out << "\nRuns finished: " << runs;
+    if (runs > 0) {
+        out << ", mean score " << totalScore / static_cast<double>(runs) << ", best " << bestScore;
+    }
+    out << "\n";
+
+    if (!recordPath.empty() && runs > 0) {
+        if (bestReplay.save(recordPath)) {
+            out << "Best run (seed " << bestReplay.getSeed() << ", " << bestReplay.getEventCount() << " actions in "
+                << bestReplay.getEncodedSize() << " bytes) saved to " << recordPath.string() << "\n";
+        }
+        else {
+            out << "Could not write " << recordPath.string() << "\n";
+        }
+    }
+}
+
+bool runReplay(const std::filesystem::path& path, const ChunkLibrary* chunks, std::ostream& out) {
+    Replay replay;
+    if (!replay.load(path)) {
+        out << "Could not read replay " << path.string() << "\n";
+        return false;
+    }
+    if (replay.getChunkHash() == 0) {
+        chunks = nullptr;
+    }
+    else if (!chunks || chunks->getHash() != replay.getChunkHash()) {
+        out << "Replay " << path.string() << " was recorded with a chunk library that is not loaded\n";
+        return false;
+    }
+
+    SimulationConfig config;
+    config.seed = replay.getSeed();
+    config.tickRate = replay.getTickRate();
+    config.loadStoredScores = false;
+    config.chunks = chunks;
+    Simulation simulation(config);
+
+    Replay::Cursor cursor(replay);
+    while (!simulation.isOver() && simulation.getTickCount() < replay.getEndTick()) {
+        for (; !cursor.done() && cursor.tick() == simulation.getTickCount(); cursor.next()) {
+            simulation.perform(cursor.action());
+        }
+        simulation.step();
+    }
+
+    out << "Replay: seed " << replay.getSeed() << ", " << replay.getTickRate() << " Hz, "
+        << replay.getEventCount() << " actions\n"
+        << "Ended at tick " << simulation.getTickCount() << " of " << replay.getEndTick();
+    if (simulation.isOver()) {
+        out << " (hit " << getObstacleSpec(simulation.getLastCollision().cause).name << ")";
+    }
+    out << "\nScore: " << simulation.getScore().getScore() << ", coins: " << simulation.getScore().getCoins()
+        << "\nChecksum: " << std::hex << simulation.getChecksum() << std::dec;
+    if (replay.getChecksum() != 0) {
+        out << (replay.getChecksum() == simulation.getChecksum() ? " (matches the recording)"
+                                                                 : " (DIVERGED from the recording)");
+    }
+    out << "\n";
+    return replay.getChecksum() == 0 || replay.getChecksum() == simulation.getChecksum();
+}
+
+bool runSpectatorCheck(std::uint64_t ticks, unsigned int tickRate, std::ostream& out) {
+    tickRate = tickRate > 0 ? tickRate : 60;
+    std::mt19937 rng(kInputSeed);
+    auto simulation = newRun(tickRate, rng);
+
+    SpectatorEncoder encoder;
+    SpectatorView fromStart;
+    SpectatorView lateJoiner;
+    std::vector<std::uint8_t> delta;
+    std::vector<std::uint8_t> keyframe;
+    std::vector<float> expected;
+    std::vector<float> actual;
+    std::uint64_t deltaBytes = 0;
+    std::uint64_t keyframes = 0;
+    std::uint64_t keyframeBytes = 0;
+    std::size_t maxDelta = 0;
+    std::uint64_t mismatches = 0;
+    std::uint64_t firstMismatch = 0;
+
+    for (std::uint64_t tick = 0; tick < ticks; ++tick) {
+        randomInput(*simulation, rng);
+        simulation->step();
+
+        const bool newRunStarted = encoder.needsReset(*simulation);
+        if (newRunStarted) {
+            encoder.reset();
+        }
+        delta.clear();
+        encoder.encodeDelta(*simulation, delta);
+        deltaBytes += delta.size();
+        maxDelta = std::max(maxDelta, delta.size());
+
+        // Subscribers get a keyframe when they join and whenever a run starts
+        const bool joinNow = tick == ticks / 2;
+        if (tick == 0 || newRunStarted || joinNow) {
+            keyframe.clear();
+            encoder.encodeKeyframe(*simulation, keyframe);
+            keyframes++;
+            keyframeBytes += keyframe.size();
+        }
+        bool ok = feedInChunks(fromStart, tick == 0 || newRunStarted ? keyframe : delta, 7) &&
+            matches(fromStart, *simulation, expected, actual);
+        if (tick >= ticks / 2) {
+            ok = feedInChunks(lateJoiner, joinNow || newRunStarted ? keyframe : delta, 3) &&
+                matches(lateJoiner, *simulation, expected, actual) && ok;
+        }
+        if (!ok && mismatches++ == 0) {
+            firstMismatch = tick;
+        }
+
+        if (simulation->isOver()) {
+            simulation = newRun(tickRate, rng);
+        }
+    }
+
+    const double bytesPerTick = ticks > 0 ? static_cast<double>(deltaBytes) / static_cast<double>(ticks) : 0.0;
+    out << "Spectator stream over " << ticks << " ticks at " << tickRate << " Hz\n"
+        << "Deltas: " << deltaBytes << " bytes, " << bytesPerTick << " bytes/tick (max " << maxDelta << "), "
+        << bytesPerTick * tickRate / 1024.0 << " KB/s\n"
+        << "Keyframes: " << keyframes << ", " << (keyframes > 0 ? keyframeBytes / keyframes : 0) << " bytes each\n"
+        << "Reconstruction: ";
+    if (mismatches == 0) {
+        out << "matches the simulation on every tick\n";
+    }
+    else {
+        out << mismatches << " mismatched ticks, first at tick " << firstMismatch << "\n";
+    }
+    return mismatches == 0;
+}
+
+bool runRewindCheck(std::uint64_t ticks, unsigned int tickRate, std::ostream& out) {
+    tickRate = tickRate > 0 ? tickRate : 60;
+    std::mt19937 rng(kInputSeed);
+    auto simulation = newRun(tickRate, rng);
+
+    RewindConfig config;
+    config.tickRate = tickRate;
+    config.baseInterval = tickRate;
+    RewindBuffer rewind(config);
+
+    // Checksum of every tick of the current run, overwritten after a rewind
+    std::vector<std::uint64_t> checksums;
+    std::vector<sf::Int64> captureMicros;
+    captureMicros.reserve(static_cast<std::size_t>(ticks));
+    std::uint64_t rewinds = 0;
+    std::uint64_t mismatches = 0;
+    std::size_t maxBytes = 0;
+    std::uint64_t captureAllocations = 0;
+    bool rewoundThisRun = false;
+
+    auto rewindTo = [&](std::uint64_t tick) {
+        if (!rewind.rewindTo(tick, *simulation) || simulation->getTickCount() > tick ||
+            simulation->getChecksum() != checksums[static_cast<std::size_t>(simulation->getTickCount())]) {
+            mismatches++;
+        }
+        rewinds++;
+    };
+
+    for (std::uint64_t tick = 0; tick < ticks; ++tick) {
+        randomInput(*simulation, rng);
+        simulation->step();
+        {
+            AllocationTracker::Guard guard("rewind capture", false);
+            rewind.capture(*simulation);
+            captureAllocations += guard.getCount();
+        }
+        captureMicros.push_back(rewind.getLastCaptureMicros());
+        maxBytes = std::max(maxBytes, rewind.getBytesUsed());
+        checksums.resize(static_cast<std::size_t>(simulation->getTickCount()) + 1);
+        checksums.back() = simulation->getChecksum();
+
+        const std::uint64_t held = rewind.getNewestTick() - rewind.getOldestTick();
+        if (tick % 997 == 996 && held > 0) {
+            rewindTo(rewind.getOldestTick() + rng() % held);
+        }
+        if (simulation->isOver()) {
+            // Practice mode: back up two seconds before the crash, once
+            if (!rewoundThisRun && simulation->getTickCount() >= rewind.getOldestTick() + 2 * tickRate) {
+                rewindTo(simulation->getTickCount() - 2 * tickRate);
+                rewoundThisRun = true;
+            }
+            else {
+                simulation = newRun(tickRate, rng);
+                rewind.clear();
+                checksums.clear();
+                rewoundThisRun = false;
+            }
+        }
+    }
+
+    std::sort(captureMicros.begin(), captureMicros.end());
+    double meanMicros = 0.0;
+    for (sf::Int64 micros : captureMicros) {
+        meanMicros += static_cast<double>(micros);
+    }
+    meanMicros = captureMicros.empty() ? 0.0 : meanMicros / static_cast<double>(captureMicros.size());
+    const sf::Int64 p99 = captureMicros.empty() ? 0 : captureMicros[captureMicros.size() * 99 / 100];
+
+    out << "Rewind buffer over " << ticks << " ticks at " << tickRate << " Hz\n"
+        << "Capture: " << meanMicros << " us mean, " << p99 << " us p99, "
+        << rewind.getMaxCaptureMicros() << " us max, " << config.captureBudgetMicros << " us budget\n"
+        << "Frames: " << rewind.getBaseFrameCount() << " base (" << rewind.getOverBudgetCount()
+        << " over budget), " << rewind.getDeltaFrameCount() << " delta, " << rewind.getSkippedCount()
+        << " ticks skipped\n"
+        << "Memory: " << maxBytes / 1024 << " KB of the " << rewind.getArenaSize() / 1024
+        << " KB frame ring used at most, " << rewind.getMemoryFootprint() / 1024 << " KB in all of a "
+        << rewind.getByteBudget() / 1024 << " KB budget\n";
+    const std::uint64_t frames = rewind.getBaseFrameCount() + rewind.getDeltaFrameCount();
+    if (frames > 0) {
+        const double bytesPerSecond = static_cast<double>(rewind.getCapturedBytes()) / frames * tickRate;
+        out << "History: " << bytesPerSecond / 1024.0 << " KB per second, so the budget holds "
+            << std::min<double>(config.seconds, rewind.getArenaSize() / bytesPerSecond) << " of "
+            << config.seconds << " s\n";
+    }
+    if (AllocationTracker::isEnabled()) {
+        out << "Capture allocations: " << captureAllocations << "\n";
+    }
+    out << "Rewinds: " << rewinds << ", ";
+    if (mismatches == 0) {
+        out << "every one restored the recorded state\n";
+    }
+    else {
+        out << mismatches << " did not restore the recorded state\n";
+    }
+    const bool withinBudget = rewind.getMaxCaptureMicros() <= config.captureBudgetMicros &&
+        rewind.getMemoryFootprint() <= rewind.getByteBudget();
+    if (!withinBudget) {
+        out << "Over budget: capture time or memory\n";
+    }
+    return mismatches == 0 && captureAllocations == 0 && withinBudget;
+}
+
+bool runTrackStreamCheck(std::uint64_t ticks, unsigned int tickRate, std::ostream& out) {
+    tickRate = tickRate > 0 ? tickRate : 60;
+    std::mt19937 rng(kInputSeed);
+    SimulationConfig config;
+    config.tickRate = tickRate;
+    config.loadStoredScores = false;
+
+    // The same run twice, with spawns decided inline and on the worker
+    std::unique_ptr<Simulation> inlineRun;
+    std::unique_ptr<Simulation> background;
+    auto newPair = [&] {
+        config.seed = static_cast<unsigned int>(rng());
+        config.backgroundTrack = false;
+        inlineRun = std::make_unique<Simulation>(config);
+        config.backgroundTrack = true;
+        background = std::make_unique<Simulation>(config);
+    };
+    newPair();
+
+    TrackStreamStats totals;
+    auto retire = [&totals](const Simulation& simulation) {
+        const TrackStreamStats stats = simulation.getTrack().getStreamStats();
+        totals.capacity = stats.capacity;
+        totals.producerStalls += stats.producerStalls;
+        totals.consumerWaits += stats.consumerWaits;
+    };
+
+    std::uint64_t mismatches = 0;
+    std::uint64_t handovers = 0;
+    std::vector<std::uint8_t> snapshot;
+    // Steps take a microsecond or two, below sf::Clock's resolution
+    using Clock = std::chrono::steady_clock;
+    Clock::duration inlineTime{};
+    Clock::duration backgroundTime{};
+    for (std::uint64_t tick = 0; tick < ticks; ++tick) {
+        std::mt19937 inputs = rng;
+        randomInput(*inlineRun, inputs);
+        randomInput(*background, rng);
+        const Clock::time_point start = Clock::now();
+        inlineRun->step();
+        const Clock::time_point middle = Clock::now();
+        background->step();
+        inlineTime += middle - start;
+        backgroundTime += Clock::now() - middle;
+
+        const TrackStreamStats stats = background->getTrack().getStreamStats();
+        totals.queued = std::max(totals.queued, stats.queued);
+        totals.ticksAhead = std::max(totals.ticksAhead, stats.ticksAhead);
+        if (background->getChecksum() != inlineRun->getChecksum() || background->isOver() != inlineRun->isOver()) {
+            mismatches++;
+            retire(*background);
+            newPair();
+            continue;
+        }
+        if (background->isOver()) {
+            retire(*background);
+            newPair();
+            continue;
+        }
+
+        // Every way a run changes hands, with decisions queued ahead
+        if (tick % 241 == 240) {
+            auto next = std::make_unique<Simulation>(config);
+            switch (handovers++ % 4) {
+            case 0: // snapshot into a fresh worker
+                snapshot.clear();
+                background->saveState(snapshot);
+                if (!next->loadState(snapshot.data(), snapshot.size())) {
+                    mismatches++;
+                }
+                break;
+            case 1: // copy into a fresh worker
+                next->cloneFrom(*background);
+                break;
+            case 2: // inline run copied over a running worker
+                background->cloneFrom(*inlineRun);
+                continue;
+            default: // worker's run copied into an inline one
+                inlineRun->cloneFrom(*background);
+                continue;
+            }
+            retire(*background);
+            background = std::move(next);
+        }
+    }
+    retire(*background);
+
+    out << "Track stream over " << ticks << " ticks at " << tickRate << " Hz\n"
+        << "Step: " << std::chrono::duration<double, std::micro>(inlineTime).count() / ticks << " us inline, "
+        << std::chrono::duration<double, std::micro>(backgroundTime).count() / ticks << " us with the worker\n"
+        << "Queue: " << totals.queued << " of " << totals.capacity << " records, "
+        << totals.ticksAhead << " ticks ahead at most\n"
+        << "Waits: " << totals.consumerWaits << " ticks waited for the worker, "
+        << totals.producerStalls << " times the worker found the queue full\n"
+        << "Handovers: " << handovers << ", ";
+    if (mismatches == 0) {
+        out << "every tick matched the inline run\n";
+    }
+    else {
+        out << mismatches << " ticks did not match the inline run\n";
+    }
+    return mismatches == 0;
+}
+
+bool runAutopilotSoak(std::uint64_t ticks, unsigned int tickRate, std::ostream& out) {
+    tickRate = tickRate > 0 ? tickRate : 60;
+    // As GameEngine: ticks are guarded once two seconds have been played
+    const std::uint64_t warmupTicks = 2 * tickRate;
+    const unsigned int kSeeds = 10;
+    if (!AllocationTracker::isEnabled()) {
+        out << "Allocation tracking is compiled out (NDEBUG); only timing decisions\n";
+    }
+
+    bool clean = true;
+    for (bool backgroundTrack : { false, true }) {
+        std::uint64_t played = 0;
+        std::uint64_t allocations = 0;
+        std::uint64_t allocatingTicks = 0;
+        std::uint64_t firstAllocatingTick = 0;
+        std::uint64_t steps = 0;
+        std::uint64_t poolHits = 0;
+        std::uint64_t poolMisses = 0;
+        sf::Int64 searchMicros = 0;
+        sf::Int64 maxSearchMicros = 0;
+        for (unsigned int seed = 1; seed <= kSeeds; ++seed) {
+            SimulationConfig config;
+            config.seed = seed;
+            config.tickRate = tickRate;
+            config.loadStoredScores = false;
+            config.backgroundTrack = backgroundTrack;
+            Simulation simulation(config);
+            Autopilot autopilot;
+            EntityPoolStats warm;
+            bool warmedUp = false;
+            for (std::uint64_t tick = 0; tick < ticks && !simulation.isOver(); ++tick) {
+                if (tick == warmupTicks) {
+                    warm = simulation.getTrack().getWorld().getPoolStats();
+                    warmedUp = true;
+                }
+                AllocationTracker::Guard guard("autopilot soak", false);
+                PlayerAction action;
+                if (autopilot.decide(simulation, action)) {
+                    AllocationTracker::Exemption replayGrowth;
+                    simulation.perform(action);
+                }
+                simulation.step();
+                steps += autopilot.getLastSearchSteps();
+                searchMicros += autopilot.getLastSearchMicros();
+                maxSearchMicros = std::max(maxSearchMicros, autopilot.getLastSearchMicros());
+                played++;
+                if (tick >= warmupTicks && guard.getCount() > 0) {
+                    allocations += guard.getCount();
+                    firstAllocatingTick = allocatingTicks++ == 0 ? tick : firstAllocatingTick;
+                }
+            }
+            const EntityPoolStats& pool = simulation.getTrack().getWorld().getPoolStats();
+            if (warmedUp) {
+                poolHits += pool.hits - warm.hits;
+                poolMisses += pool.misses - warm.misses;
+            }
+        }
+        const double perTick = played > 0 ? static_cast<double>(searchMicros) / played : 0.0;
+        const double perStep = steps > 0 ? static_cast<double>(searchMicros) / steps : 0.0;
+        out << (backgroundTrack ? "Worker track: " : "Inline track: ") << kSeeds << " runs, " << played
+            << " ticks, decisions " << perTick << " us mean, " << maxSearchMicros << " us max, "
+            << perStep << " us per simulated tick\n"
+            << "  Entity pool after warm-up: " << poolHits << " spawns reused storage, " << poolMisses
+            << " grew it\n";
+        if (poolMisses > 0) {
+            clean = false;
+        }
+        if (allocatingTicks > 0) {
+            out << "  " << allocations << " allocations on " << allocatingTicks
+                << " ticks after warm-up, first at tick " << firstAllocatingTick << "\n";
+            clean = false;
+        }
+    }
+    if (clean && AllocationTracker::isEnabled()) {
+        out << "No allocations after warm-up\n";
+    }
+    return clean;
+}
+
+namespace {
+    // FNV-1a over 'count' values' bytes, for comparing VecEnv outputs
+    template <typename T> void hashValues(std::uint64_t& hash, const T* values, std::size_t count) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values);
+        for (std::size_t i = 0; i < count * sizeof(T); ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+        }
+    }
+
+    // Steps 'env' with random actions (mostly NOOP, like a player between key
+    // presses) and hashes the outputs of the first 'hashSteps' steps.
+    struct VecEnvRun {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        std::uint64_t episodes = 0;
+        double reward = 0.0;
+        float seconds = 0.0f;
+    };
+
+    VecEnvRun stepRandomly(VecEnv& env, std::uint64_t steps, std::uint64_t hashSteps) {
+        const std::size_t count = env.size();
+        std::vector<float> observations(count * VecEnv::OBSERVATION_SIZE);
+        std::vector<float> rewards(count);
+        std::vector<std::uint8_t> dones(count);
+        std::vector<std::uint8_t> actions(count);
+        std::mt19937 rng(kInputSeed);
+        VecEnvRun run;
+
+        sf::Clock clock;
+        env.reset(observations.data());
+        for (std::uint64_t step = 0; step < steps; ++step) {
+            for (std::uint8_t& action : actions) {
+                const std::uint32_t roll = rng();
+                action = VecEnv::NOOP;
+                if (roll % 8 == 0) {
+                    action = static_cast<std::uint8_t>(1 + (roll >> 3) % (VecEnv::ACTION_COUNT - 1));
+                }
+            }
+            env.step(actions.data(), observations.data(), rewards.data(), dones.data());
+            for (std::size_t i = 0; i < count; ++i) {
+                run.reward += rewards[i];
+                run.episodes += dones[i] != VecEnv::RUNNING ? 1 : 0;
+            }
+            if (step < hashSteps) {
+                hashValues(run.hash, observations.data(), observations.size());
+                hashValues(run.hash, rewards.data(), rewards.size());
+                hashValues(run.hash, dones.data(), dones.size());
+            }
+        }
+        run.seconds = clock.getElapsedTime().asSeconds();
+        return run;
+    }
+}
+
+bool runVecEnvBenchmark(const VecEnvConfig& config, std::uint64_t steps, std::ostream& out) {
+    const std::uint64_t checkSteps = std::min<std::uint64_t>(steps, 3600);
+    VecEnv env(config);
+    const VecEnvRun run = stepRandomly(env, steps, checkSteps);
+    const double envSteps = static_cast<double>(steps) * static_cast<double>(env.size());
+
+    out << env.size() << " environments on " << env.getThreadCount() << " threads, " << steps << " steps\n"
+        << "Throughput: " << (run.seconds > 0.0f ? envSteps / run.seconds : 0.0) << " env-steps/s ("
+        << run.seconds << " s)\n"
+        << "Episodes finished: " << run.episodes << ", mean reward per env-step "
+        << (envSteps > 0.0 ? run.reward / envSteps : 0.0) << "\n";
+
+    VecEnvConfig serialConfig = config;
+    serialConfig.threads = 1;
+    VecEnv serial(serialConfig);
+    const bool matches = stepRandomly(serial, checkSteps, checkSteps).hash == run.hash;
+    out << "Determinism: first " << checkSteps << " steps on one thread "
+        << (matches ? "match" : "DIFFER") << "\n";
+    return matches;
+}
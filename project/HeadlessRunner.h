@@ -0,0 +1,52 @@
+#pragma once
+#include "VecEnv.h"
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+
+// Runs the simulation with no window for 'ticks' fixed ticks of
+// 1 / tickRate seconds, as fast as the CPU allows. Random lane changes,
+// jumps and slides stand in for the player; a new run starts whenever one
+// ends. Prints throughput and per-run results to 'out', and saves the best
+// run's replay to 'recordPath' if one is given. Tracks are built from
+// 'chunks' when it is not null.
+void runHeadless(std::uint64_t ticks, unsigned int tickRate, const ChunkLibrary* chunks, std::ostream& out,
+    const std::filesystem::path& recordPath = std::filesystem::path());
+
+// Plays a recorded run back headless and prints where it ended and the
+// final state checksum. A run recorded with a chunk library is played with
+// 'chunks', which must be that library. Returns false if the file could not
+// be read, its library is not the one given, or the run did not reproduce
+// the recorded checksum.
+bool runReplay(const std::filesystem::path& path, const ChunkLibrary* chunks, std::ostream& out);
+
+// Offline check of the spectator stream: encodes every tick of 'ticks'
+// random-input ticks, decodes it in odd-sized chunks (plus a subscriber that
+// joins halfway through) and compares the rebuilt player, score and entities
+// with the simulation. Prints bytes per tick. Returns false on a mismatch.
+bool runSpectatorCheck(std::uint64_t ticks, unsigned int tickRate, std::ostream& out);
+
+// Exercises the practice-mode rewind buffer: captures every tick of 'ticks'
+// random-input ticks, rewinds to an earlier held tick now and then (and once
+// after each crash) and checks the restored state's checksum against the one
+// recorded when that tick first ran. Prints capture cost, memory used and
+// how many seconds the buffer holds. Returns false on a mismatch.
+bool runRewindCheck(std::uint64_t ticks, unsigned int tickRate, std::ostream& out);
+
+// Runs the same random-input runs with spawns decided inline and on a
+// background TrackGeneratorThread, handing the threaded run over by
+// snapshot and by copy now and then, and compares their checksums every
+// tick. Prints step cost, queue depth and waits. Returns false on a mismatch.
+bool runTrackStreamCheck(std::uint64_t ticks, unsigned int tickRate, std::ostream& out);
+
+// Lets the autopilot play runs of up to 'ticks' ticks on 10 seeds, with the
+// track generated inline and on its worker, counting heap allocations per
+// tick as GameEngine's frame guard does. Prints decision cost. Returns false
+// if any tick after warm-up allocated.
+bool runAutopilotSoak(std::uint64_t ticks, unsigned int tickRate, std::ostream& out);
+
+// Steps a VecEnv of config.envs environments 'steps' times with random
+// actions and prints env-steps per second, episodes finished and mean
+// reward. Then repeats the first steps on one thread and checks every
+// observation, reward and done matches. Returns false if they differ.
+bool runVecEnvBenchmark(const VecEnvConfig& config, std::uint64_t steps, std::ostream& out);
@@ -0,0 +1,43 @@
+#include "InputPolicy.h"
+#include "Autopilot.h"
+
+namespace {
+    // Chance per tick of pressing something (at 60 Hz).
+    const float kRandomInputRate = 1.0f / 30.0f;
+
+    struct NamedPolicy {
+        const char* name;
+        InputPolicy policy;
+    };
+
+    const NamedPolicy kPolicies[] = {
+        { "idle", &idleInput },
+        { "random", &randomInput },
+        { "bot", &autopilotInput },
+    };
+}
+
+void idleInput(Simulation& /*simulation*/, std::mt19937& /*rng*/) {}
+
+void randomInput(Simulation& simulation, std::mt19937& rng) {
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    if (chance(rng) >= kRandomInputRate) {
+        return;
+    }
+    simulation.perform(static_cast<PlayerAction>(std::uniform_int_distribution<int>(0, 3)(rng)));
+}
+
+void autopilotInput(Simulation& simulation, std::mt19937& /*rng*/) {
+    // Batch workers each get their own; play() notices when a new run starts
+    thread_local Autopilot autopilot;
+    autopilot.play(simulation);
+}
+
+InputPolicy findInputPolicy(const std::string& name) {
+    for (const NamedPolicy& entry : kPolicies) {
+        if (name == entry.name) {
+            return entry.policy;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "Simulation.h"
+#include <random>
+#include <string>
+
+// Stand-in for a human at the keys in headless and batch runs. Called once
+// per tick before the step and acts through Simulation::perform(), so its
+// presses are recorded like a human's. The rng belongs to the run, so runs
+// with the same seed press the same keys.
+using InputPolicy = void (*)(Simulation& simulation, std::mt19937& rng);
+
+// Never presses anything.
+void idleInput(Simulation& simulation, std::mt19937& rng);
+
+// Presses a random lane change, jump or slide about twice a second.
+void randomInput(Simulation& simulation, std::mt19937& rng);
+
+// Plays with an Autopilot (one per thread), looking a few seconds ahead.
+void autopilotInput(Simulation& simulation, std::mt19937& rng);
+
+// Looks a policy up by name ("idle", "random", "bot"). Returns nullptr if unknown.
+InputPolicy findInputPolicy(const std::string& name);
@@ -0,0 +1,78 @@
+#include "LaneGrid.h"
+#include "Obstacle.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // The player's running hitbox (Player's ground line and height)
+    const float kPlayerTop = 400.0f;
+    const float kPlayerBottom = 500.0f;
+
+    static_assert(LaneSystem::LANE_COUNT == 3, "the lane masks below assume three lanes");
+    const std::uint16_t kLeftLanes = 0b001001001;  // lane 0 of every pose
+    const std::uint16_t kRightLanes = 0b100100100; // lane 2 of every pose
+
+    // Every state one lane over or staying, in each pose at once
+    std::uint16_t spread(std::uint16_t states) {
+        return states | ((states << 1) & ~kLeftLanes) | ((states >> 1) & ~kRightLanes);
+    }
+}
+
+void LaneGrid::advance(float seconds) {
+    mSeconds += seconds;
+    const std::uint64_t head = static_cast<std::uint64_t>(mSeconds / SLOT_SECONDS);
+    for (; mHead < head; ++mHead) {
+        mSlots[mHead & (SLOT_COUNT - 1)] = ALL_OPEN;
+    }
+}
+
+void LaneGrid::addObstacle(int lane, float y, float height, float speed, std::uint8_t clearance) {
+    if (speed <= 0.0f) {
+        return;
+    }
+    // From its bottom edge reaching the player's head to its top edge
+    // passing the player's feet
+    const double arrives = mSeconds + (kPlayerTop - y) / speed;
+    const double leaves = mSeconds + (kPlayerBottom - (y - height)) / speed;
+    const std::uint64_t first = std::max(mHead, static_cast<std::uint64_t>(std::max(0.0, arrives) / SLOT_SECONDS));
+    const std::uint64_t last = std::min(mHead + SLOT_COUNT - 1,
+        static_cast<std::uint64_t>(std::max(0.0, leaves) / SLOT_SECONDS));
+
+    const std::uint16_t laneBit = static_cast<std::uint16_t>(1u << lane);
+    std::uint16_t blocked = static_cast<std::uint16_t>(laneBit << (RUN * LaneSystem::LANE_COUNT));
+    if (!(clearance & CLEAR_BY_JUMP)) {
+        blocked |= static_cast<std::uint16_t>(laneBit << (AIR * LaneSystem::LANE_COUNT));
+    }
+    if (!(clearance & CLEAR_BY_SLIDE)) {
+        blocked |= static_cast<std::uint16_t>(laneBit << (SLIDE * LaneSystem::LANE_COUNT));
+    }
+    for (std::uint64_t slot = first; slot <= last; ++slot) {
+        mSlots[slot & (SLOT_COUNT - 1)] &= static_cast<std::uint16_t>(~blocked);
+    }
+    mMarkedEnd = std::max(mMarkedEnd, last + 1);
+}
+
+std::uint16_t LaneGrid::getSafeStates() const {
+    // Past the last marked slot everything is open. Running or sliding,
+    // the player can go on in any pose; in the air, only stay up or land.
+    std::uint16_t safe = ALL_OPEN;
+    for (std::uint64_t i = mMarkedEnd > mHead ? mMarkedEnd - mHead : 0; i-- > 0;) {
+        const std::uint16_t next = spread(safe);
+        const std::uint16_t anyPose = (next | next >> 3 | next >> 6) & 0b111;
+        const std::uint16_t airOrRun = (next | next >> 3) & 0b111;
+        safe = mSlots[(mHead + i) & (SLOT_COUNT - 1)] &
+            static_cast<std::uint16_t>(anyPose << (RUN * 3) | airOrRun << (AIR * 3) | anyPose << (SLIDE * 3));
+    }
+    return safe;
+}
+
+void LaneGrid::saveState(SnapshotWriter& writer) const {
+    writer.value(mSlots);
+    writer.value(mHead);
+    writer.value(mMarkedEnd);
+    writer.value(mSeconds);
+}
+
+bool LaneGrid::loadState(SnapshotReader& reader) {
+    return reader.value(mSlots) && reader.value(mHead) && reader.value(mMarkedEnd) && reader.value(mSeconds);
+}
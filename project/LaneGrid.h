@@ -0,0 +1,58 @@
+#pragma once
+#include "LaneSystem.h"
+#include "Snapshot.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// The next few seconds of track as the player's row will meet it, in time
+// slots of SLOT_SECONDS. Each slot is three lane bitsets packed in one
+// word: the lanes passable running, in the air and sliding. An obstacle
+// clears its lane's bit from every pose that does not get past it, so a
+// slot also tells what each lane asks for - nothing, a jump, a slide,
+// either, or another lane.
+//
+// getSafeStates() walks the marked slots backwards, a few bitwise
+// operations each, to find the lanes and poses at the current slot from
+// which the whole horizon can be passed, moving at most one lane and
+// changing pose once per slot. Jumps are taken to last as long as needed,
+// so cells that need a jump in every lane for longer than one jump are
+// not caught.
+class LaneGrid {
+public:
+    static constexpr std::size_t SLOT_COUNT = 128; // a power of two
+    static constexpr float SLOT_SECONDS = 1.0f / 16.0f;
+
+    // Bit (pose * LANE_COUNT + lane) of a slot or a state set.
+    enum Pose { RUN, AIR, SLIDE, POSE_COUNT };
+    static constexpr std::uint16_t ALL_OPEN = (1u << (POSE_COUNT * LaneSystem::LANE_COUNT)) - 1;
+
+    LaneGrid() { mSlots.fill(ALL_OPEN); }
+
+    // Moves 'seconds' of track time on; slots left behind are reused, free,
+    // at the far end.
+    void advance(float seconds);
+
+    // An obstacle 'height' px tall whose bottom edge is at 'y', scrolling
+    // down at 'speed' px/s from now. 'clearance' is its ObstacleClearance
+    // flags. Slots past the horizon are not marked.
+    void addObstacle(int lane, float y, float height, float speed, std::uint8_t clearance);
+
+    // Lanes passable in 'pose', 'slot' slots from the current one.
+    std::uint8_t getOpenLanes(std::size_t slot, Pose pose) const {
+        return (mSlots[(mHead + slot) & (SLOT_COUNT - 1)] >> (pose * LaneSystem::LANE_COUNT)) &
+            ((1u << LaneSystem::LANE_COUNT) - 1);
+    }
+
+    // States at the current slot from which every slot can be passed.
+    std::uint16_t getSafeStates() const;
+
+    void saveState(SnapshotWriter& writer) const;
+    bool loadState(SnapshotReader& reader);
+
+private:
+    std::array<std::uint16_t, SLOT_COUNT> mSlots; // ring starting at mHead
+    std::uint64_t mHead = 0; // slots passed since the start
+    std::uint64_t mMarkedEnd = 0; // one past the farthest slot marked; all open from there
+    double mSeconds = 0.0;   // track time since the start
+};
@@ -0,0 +1,196 @@
+#include "LaneIndex.h"
+#include "Simd.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+    // Ring size the first push gets when nothing was reserved.
+    const size_t kMinCapacity = 16;
+
+    // Copies the 'count' entries from slot 'head' on to the front of a new
+    // ring of 'capacity' slots.
+    template <typename T> void regrow(std::vector<T>& column, size_t head, size_t count, size_t capacity) {
+        std::vector<T> ring(capacity);
+        for (size_t i = 0; i < count; ++i) {
+            ring[i] = column[(head + i) & (column.size() - 1)];
+        }
+        column.swap(ring);
+    }
+
+    // Overlap kernel over 'count' consecutive slots, bit i for slot i.
+    std::uint64_t overlapSpan(const float* minX, const float* minY, const float* maxX, const float* maxY,
+        size_t count, float left, float top, float right, float bottom) {
+        std::uint64_t mask = 0;
+        size_t i = 0;
+#if defined(TRACK_SIMD_AVX)
+        const __m256 vl = _mm256_set1_ps(left);
+        const __m256 vt = _mm256_set1_ps(top);
+        const __m256 vr = _mm256_set1_ps(right);
+        const __m256 vb = _mm256_set1_ps(bottom);
+        for (; i + 8 <= count; i += 8) {
+            __m256 hit = _mm256_and_ps(
+                _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(minX + i), vr, _CMP_LT_OQ),
+                    _mm256_cmp_ps(_mm256_loadu_ps(maxX + i), vl, _CMP_GT_OQ)),
+                _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(minY + i), vb, _CMP_LT_OQ),
+                    _mm256_cmp_ps(_mm256_loadu_ps(maxY + i), vt, _CMP_GT_OQ)));
+            mask |= static_cast<std::uint64_t>(_mm256_movemask_ps(hit)) << i;
+        }
+#elif defined(TRACK_SIMD_SSE)
+        const __m128 vl = _mm_set1_ps(left);
+        const __m128 vt = _mm_set1_ps(top);
+        const __m128 vr = _mm_set1_ps(right);
+        const __m128 vb = _mm_set1_ps(bottom);
+        for (; i + 4 <= count; i += 4) {
+            __m128 hit = _mm_and_ps(
+                _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(minX + i), vr), _mm_cmpgt_ps(_mm_loadu_ps(maxX + i), vl)),
+                _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(minY + i), vb), _mm_cmpgt_ps(_mm_loadu_ps(maxY + i), vt)));
+            mask |= static_cast<std::uint64_t>(_mm_movemask_ps(hit)) << i;
+        }
+#endif
+        for (; i < count; ++i) {
+            if (minX[i] < right && maxX[i] > left && minY[i] < bottom && maxY[i] > top) {
+                mask |= std::uint64_t(1) << i;
+            }
+        }
+        return mask;
+    }
+}
+
+void LaneBuffer::reserve(size_t capacity) {
+    if (capacity > mAnchor.size()) {
+        grow(std::bit_ceil(capacity));
+    }
+}
+
+void LaneBuffer::clear() {
+    mHead = 0;
+    mCount = 0;
+}
+
+void LaneBuffer::grow(size_t capacity) {
+    regrow(mAnchor, mHead, mCount, capacity);
+    regrow(mMinX, mHead, mCount, capacity);
+    regrow(mMinY, mHead, mCount, capacity);
+    regrow(mMaxX, mHead, mCount, capacity);
+    regrow(mMaxY, mHead, mCount, capacity);
+    regrow(mHandles, mHead, mCount, capacity);
+    regrow(mArchetypes, mHead, mCount, capacity);
+    regrow(mKinds, mHead, mCount, capacity);
+    mHead = 0;
+}
+
+void LaneBuffer::moveSlot(size_t from, size_t to) {
+    mAnchor[to] = mAnchor[from];
+    mMinX[to] = mMinX[from];
+    mMinY[to] = mMinY[from];
+    mMaxX[to] = mMaxX[from];
+    mMaxY[to] = mMaxY[from];
+    mHandles[to] = mHandles[from];
+    mArchetypes[to] = mArchetypes[from];
+    mKinds[to] = mKinds[from];
+}
+
+void LaneBuffer::push(EntityHandle handle, std::uint8_t archetype, std::uint8_t kind, float anchor,
+    const sf::FloatRect& box) {
+    if (mCount == mAnchor.size()) {
+        grow(std::max(kMinCapacity, mAnchor.size() * 2));
+    }
+    // Move up one slot anything that sits higher up the track.
+    size_t index = mCount;
+    for (; index > 0 && mAnchor[slot(index - 1)] < anchor; --index) {
+        moveSlot(slot(index - 1), slot(index));
+    }
+    const size_t k = slot(index);
+    mAnchor[k] = anchor;
+    mMinX[k] = box.left;
+    mMinY[k] = box.top;
+    mMaxX[k] = box.left + box.width;
+    mMaxY[k] = box.top + box.height;
+    mHandles[k] = handle;
+    mArchetypes[k] = archetype;
+    mKinds[k] = kind;
+    ++mCount;
+}
+
+void LaneBuffer::popFront() {
+    mHead = slot(1);
+    --mCount;
+}
+
+void LaneBuffer::window(float top, float bottom, size_t& begin, size_t& end) const {
+    // Anchors descend from the front: skip those below 'bottom', stop above 'top'.
+    size_t lo = 0;
+    size_t hi = mCount;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (mAnchor[slot(mid)] > bottom) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    size_t last = lo;
+    while (last < mCount && mAnchor[slot(last)] >= top) {
+        ++last;
+    }
+    begin = lo;
+    end = last;
+}
+
+std::uint64_t LaneBuffer::overlapMask(size_t begin, size_t count, float left, float top, float right,
+    float bottom) const {
+    // The entries are one run of slots, or two when they wrap past the end.
+    const size_t first = slot(begin);
+    const size_t run = std::min(count, mAnchor.size() - first);
+    std::uint64_t mask = overlapSpan(mMinX.data() + first, mMinY.data() + first, mMaxX.data() + first,
+        mMaxY.data() + first, run, left, top, right, bottom);
+    if (run < count) {
+        mask |= overlapSpan(mMinX.data(), mMinY.data(), mMaxX.data(), mMaxY.data(), count - run, left, top, right,
+            bottom) << run;
+    }
+    return mask;
+}
+
+void LaneBuffer::shift(float delta) {
+    for (size_t i = 0; i < mCount; ++i) {
+        const size_t k = slot(i);
+        mAnchor[k] += delta;
+        mMinY[k] += delta;
+        mMaxY[k] += delta;
+    }
+}
+
+void LaneBuffer::saveState(SnapshotWriter& writer) const {
+    writer.values(mAnchor, mHead, mCount);
+    writer.values(mMinX, mHead, mCount);
+    writer.values(mMinY, mHead, mCount);
+    writer.values(mMaxX, mHead, mCount);
+    writer.values(mMaxY, mHead, mCount);
+    writer.values(mHandles, mHead, mCount);
+    writer.values(mArchetypes, mHead, mCount);
+    writer.values(mKinds, mHead, mCount);
+}
+
+bool LaneBuffer::loadState(SnapshotReader& reader) {
+    // Entries come back in order at the front of the ring, which keeps its
+    // size unless they no longer fit.
+    const size_t capacity = mAnchor.size();
+    bool ok = reader.values(mAnchor) && reader.values(mMinX) && reader.values(mMinY) && reader.values(mMaxX) &&
+        reader.values(mMaxY) && reader.values(mHandles) && reader.values(mArchetypes) && reader.values(mKinds);
+    const size_t count = mAnchor.size();
+    ok = ok && mMinX.size() == count && mMinY.size() == count && mMaxX.size() == count &&
+        mMaxY.size() == count && mHandles.size() == count && mArchetypes.size() == count && mKinds.size() == count;
+    const size_t ring = std::max(capacity, std::bit_ceil(count));
+    mAnchor.resize(ring);
+    mMinX.resize(ring);
+    mMinY.resize(ring);
+    mMaxX.resize(ring);
+    mMaxY.resize(ring);
+    mHandles.resize(ring);
+    mArchetypes.resize(ring);
+    mKinds.resize(ring);
+    mHead = 0;
+    mCount = ok ? count : 0;
+    return ok;
+}
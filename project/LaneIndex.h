@@ -0,0 +1,190 @@
+#pragma once
+#include "EntityHandle.h"
+#include "LaneSystem.h"
+#include "Snapshot.h"
+#include <SFML/Graphics/Rect.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// What a lane query reports for each overlapping entry.
+struct LaneHit {
+    EntityHandle handle;
+    std::uint8_t archetype;
+    std::uint8_t kind;
+    sf::FloatRect box; // screen space
+};
+
+// One lane's entities as parallel arrays, sorted by track position with the
+// lowest on screen (next to expire) at the front. Each entry caches its AABB
+// in track space: written once at spawn and shifted implicitly by the
+// owner's scroll offset, so boxes never need recomputing while scrolling.
+//
+// The arrays are a ring of power-of-two size: the live entries are the
+// size() slots from mHead on, wrapping at the end. popFront() and the usual
+// append are O(1); an entry spawned behind others moves those up one slot.
+// A full ring doubles, which allocates and copies, so reserve() up front.
+class LaneBuffer {
+public:
+    void reserve(size_t capacity);
+    void clear();
+
+    size_t size() const { return mCount; }
+    bool empty() const { return mCount == 0; }
+    bool full() const { return mCount == mAnchor.size(); }
+
+    // Inserts keeping track order. Spawns enter at the top of the screen,
+    // so this nearly always appends.
+    void push(EntityHandle handle, std::uint8_t archetype, std::uint8_t kind, float anchor, const sf::FloatRect& box);
+
+    float frontAnchor() const { return mAnchor[mHead]; }
+    EntityHandle frontHandle() const { return mHandles[mHead]; }
+    void popFront();
+
+    // Entries (0 = front) whose anchor lies in [top, bottom], track space.
+    void window(float top, float bottom, size_t& begin, size_t& end) const;
+
+    // Overlap kernel: bit i is set when entry begin + i overlaps the box
+    // (track space, strict edges like sf::FloatRect::intersects). count <= 64.
+    std::uint64_t overlapMask(size_t begin, size_t count, float left, float top, float right, float bottom) const;
+
+    LaneHit getHit(size_t i, float scroll) const {
+        const size_t k = slot(i);
+        return LaneHit{ mHandles[k], mArchetypes[k], mKinds[k],
+            sf::FloatRect(mMinX[k], mMinY[k] + scroll, mMaxX[k] - mMinX[k], mMaxY[k] - mMinY[k]) };
+    }
+
+    void shift(float delta);
+
+    void saveState(SnapshotWriter& writer) const;
+    bool loadState(SnapshotReader& reader);
+
+private:
+    // Ring slot of entry i (0 = front).
+    size_t slot(size_t i) const { return (mHead + i) & (mAnchor.size() - 1); }
+    void grow(size_t capacity);
+    void moveSlot(size_t from, size_t to);
+
+    std::vector<float> mAnchor;
+    std::vector<float> mMinX;
+    std::vector<float> mMinY;
+    std::vector<float> mMaxX;
+    std::vector<float> mMaxY;
+    std::vector<EntityHandle> mHandles;
+    std::vector<std::uint8_t> mArchetypes;
+    std::vector<std::uint8_t> mKinds;
+    size_t mHead = 0; // slot of the front entry
+    size_t mCount = 0;
+};
+
+// A LaneBuffer per lane for entities that stay in their lane and scroll with
+// the track. Positions are stored relative to the total scroll distance, so
+// advancing the track is O(1), expiry pops from the fronts and an overlap
+// query is a binary search for the y window plus a SIMD sweep over it.
+class LaneIndex {
+public:
+    // Stored positions are rebased once the scroll distance gets this large,
+    // to keep float precision.
+    static constexpr float REBASE_DISTANCE = 65536.0f;
+
+    void reserve(size_t perLane) {
+        for (LaneBuffer& lane : mLanes) {
+            lane.reserve(perLane);
+        }
+    }
+
+    void clear() {
+        for (LaneBuffer& lane : mLanes) {
+            lane.clear();
+        }
+        mScroll = 0.0f;
+    }
+
+    void insert(int lane, EntityHandle handle, std::uint8_t archetype, std::uint8_t kind, float anchorY,
+        const sf::FloatRect& box) {
+        sf::FloatRect trackBox(box.left, box.top - mScroll, box.width, box.height);
+        mLanes[lane].push(handle, archetype, kind, anchorY - mScroll, trackBox);
+    }
+
+    void advance(float dy) {
+        mScroll += dy;
+        if (mScroll > REBASE_DISTANCE) {
+            for (LaneBuffer& lane : mLanes) {
+                lane.shift(mScroll);
+            }
+            mScroll = 0.0f;
+        }
+    }
+
+    // Pops every entry whose anchor is past 'limitY' and calls onExpire(handle).
+    template <typename OnExpire> void expire(float limitY, OnExpire onExpire) {
+        const float limit = limitY - mScroll;
+        for (LaneBuffer& lane : mLanes) {
+            while (!lane.empty() && lane.frontAnchor() > limit) {
+                EntityHandle handle = lane.frontHandle();
+                lane.popFront();
+                onExpire(handle);
+            }
+        }
+    }
+
+    // Calls visit(const LaneHit&) for each entry in 'lane' whose anchor is in
+    // [anchorTop, anchorBottom] and whose box overlaps 'box'.
+    template <typename Visit>
+    void forEachOverlap(int lane, float anchorTop, float anchorBottom, const sf::FloatRect& box, Visit visit) const {
+        const LaneBuffer& buffer = mLanes[lane];
+        size_t begin;
+        size_t end;
+        buffer.window(anchorTop - mScroll, anchorBottom - mScroll, begin, end);
+        const float top = box.top - mScroll;
+        for (size_t block = begin; block < end; block += 64) {
+            const size_t count = end - block < 64 ? end - block : 64;
+            std::uint64_t mask = buffer.overlapMask(block, count, box.left, top, box.left + box.width, top + box.height);
+            for (size_t bit = 0; mask; ++bit, mask >>= 1) {
+                if (mask & 1u) {
+                    visit(buffer.getHit(block + bit, mScroll));
+                }
+            }
+        }
+    }
+
+    // Calls visit(const LaneHit&) for every entry, lane by lane.
+    template <typename Visit> void forEach(Visit visit) const {
+        for (const LaneBuffer& lane : mLanes) {
+            for (size_t i = 0; i < lane.size(); ++i) {
+                visit(lane.getHit(i, mScroll));
+            }
+        }
+    }
+
+    bool isFull(int lane) const { return mLanes[lane].full(); }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const LaneBuffer& lane : mLanes) {
+            total += lane.size();
+        }
+        return total;
+    }
+
+    void saveState(SnapshotWriter& writer) const {
+        for (const LaneBuffer& lane : mLanes) {
+            lane.saveState(writer);
+        }
+        writer.value(mScroll);
+    }
+
+    bool loadState(SnapshotReader& reader) {
+        for (LaneBuffer& lane : mLanes) {
+            if (!lane.loadState(reader)) {
+                return false;
+            }
+        }
+        return reader.value(mScroll);
+    }
+
+private:
+    std::array<LaneBuffer, LaneSystem::LANE_COUNT> mLanes;
+    float mScroll = 0.0f;
+};
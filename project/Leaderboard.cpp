@@ -0,0 +1,111 @@
+#include "Leaderboard.h"
+#include <algorithm>
+#include <functional>
+#include <sstream>
+
+namespace {
+    // Keeps the log one entry per line: "score coins name".
+    void sanitize(std::string& name) {
+        if (name.size() > Leaderboard::MAX_NAME_LENGTH) {
+            name.resize(Leaderboard::MAX_NAME_LENGTH);
+        }
+        for (char& c : name) {
+            if (static_cast<unsigned char>(c) < 0x20 || c == 0x7F) {
+                c = '_';
+            }
+        }
+        if (name.empty()) {
+            name = "Player";
+        }
+    }
+
+    // Batches replayed from the log are committed this many lines at a time.
+    const std::size_t kReplayBatch = 4096;
+}
+
+Leaderboard::Leaderboard(std::size_t topSize) : mTopSize(topSize > 0 ? topSize : DEFAULT_TOP_SIZE) {
+    mTop.reserve(mTopSize * 2);
+}
+
+bool Leaderboard::open(const std::filesystem::path& path) {
+    std::ifstream existing(path);
+    std::vector<LeaderboardEntry> batch;
+    batch.reserve(kReplayBatch);
+    std::string line;
+    while (std::getline(existing, line)) {
+        std::istringstream fields(line);
+        LeaderboardEntry entry;
+        if (!(fields >> entry.score >> entry.coins)) {
+            continue; // torn or foreign line
+        }
+        fields.get(); // the space before the name
+        std::getline(fields, entry.name);
+        batch.push_back(std::move(entry));
+        if (batch.size() == kReplayBatch) {
+            merge(batch);
+        }
+    }
+    merge(batch);
+
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    mLog.open(path, std::ios::app);
+    return mLog.is_open();
+}
+
+void Leaderboard::commit(std::vector<LeaderboardEntry>& batch) {
+    if (batch.empty()) {
+        return;
+    }
+    for (LeaderboardEntry& entry : batch) {
+        sanitize(entry.name);
+    }
+    if (mLog.is_open()) {
+        // Group commit: the whole batch reaches the file in one write
+        std::ostringstream lines;
+        for (const LeaderboardEntry& entry : batch) {
+            lines << entry.score << ' ' << entry.coins << ' ' << entry.name << '\n';
+        }
+        mLog << lines.str();
+        mLog.flush();
+    }
+    merge(batch);
+    mBatches++;
+}
+
+void Leaderboard::merge(std::vector<LeaderboardEntry>& batch) {
+    if (batch.empty()) {
+        return;
+    }
+    // Sorted batch merged into the sorted array: O(n + k log k) per batch
+    mMergeScratch.clear();
+    for (const LeaderboardEntry& entry : batch) {
+        mMergeScratch.push_back(entry.score);
+    }
+    std::sort(mMergeScratch.begin(), mMergeScratch.end(), std::greater<std::uint32_t>());
+    const std::size_t middle = mScores.size();
+    mScores.insert(mScores.end(), mMergeScratch.begin(), mMergeScratch.end());
+    std::inplace_merge(mScores.begin(), mScores.begin() + static_cast<std::ptrdiff_t>(middle), mScores.end(),
+        std::greater<std::uint32_t>());
+
+    // Only entries that can still make the top list are kept by name
+    const std::uint32_t cutoff = mTop.size() < mTopSize ? 0 : mTop.back().score;
+    for (LeaderboardEntry& entry : batch) {
+        if (mTop.size() < mTopSize || entry.score > cutoff) {
+            mTop.push_back(std::move(entry));
+        }
+    }
+    std::stable_sort(mTop.begin(), mTop.end(),
+        [](const LeaderboardEntry& a, const LeaderboardEntry& b) { return a.score > b.score; });
+    if (mTop.size() > mTopSize) {
+        mTop.resize(mTopSize);
+    }
+    batch.clear();
+}
+
+std::uint64_t Leaderboard::rankOf(std::uint32_t score) const {
+    auto firstNotAbove = std::lower_bound(mScores.begin(), mScores.end(), score, std::greater<std::uint32_t>());
+    return static_cast<std::uint64_t>(firstNotAbove - mScores.begin()) + 1;
+}
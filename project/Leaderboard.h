@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct LeaderboardEntry {
+    std::string name;
+    std::uint32_t score;
+    std::uint32_t coins;
+};
+
+// Global board kept by the leaderboard daemon. Every submitted score is kept
+// in one descending array so a rank query is a binary search; the names are
+// only kept for the best 'topSize' entries.
+//
+// Results are added in batches: commit() sorts the batch and merges it in
+// one pass instead of inserting entry by entry, and appends the whole batch
+// to the on-disk log with a single write and flush.
+class Leaderboard {
+public:
+    static constexpr std::size_t DEFAULT_TOP_SIZE = 100;
+    static constexpr std::size_t MAX_NAME_LENGTH = 32;
+
+    explicit Leaderboard(std::size_t topSize = DEFAULT_TOP_SIZE);
+
+    // Replays the log at 'path' into the board and keeps appending every
+    // committed batch to it. Returns false if the file cannot be opened for
+    // appending (the board then stays in memory only).
+    bool open(const std::filesystem::path& path);
+
+    // Adds every entry in 'batch' and empties it. Names are clamped to
+    // MAX_NAME_LENGTH printable characters.
+    void commit(std::vector<LeaderboardEntry>& batch);
+
+    // 1 + the number of stored scores strictly above 'score'.
+    std::uint64_t rankOf(std::uint32_t score) const;
+    std::uint64_t size() const { return mScores.size(); }
+    std::uint64_t getBatchCount() const { return mBatches; }
+
+    // Best entries first; ties keep submission order.
+    const std::vector<LeaderboardEntry>& getTop() const { return mTop; }
+
+private:
+    void merge(std::vector<LeaderboardEntry>& batch);
+
+    std::size_t mTopSize;
+    std::vector<std::uint32_t> mScores; // every score, descending
+    std::vector<std::uint32_t> mMergeScratch;
+    std::vector<LeaderboardEntry> mTop;
+    std::ofstream mLog;
+    std::uint64_t mBatches = 0;
+};
@@ -0,0 +1,544 @@
+#include "LeaderboardService.h"
+#include "Varint.h"
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace LeaderboardProtocol;
+
+namespace {
+    // Frames are length-prefixed with a varint padded to three bytes, so a
+    // message can be written straight into the output and its length patched
+    // in afterwards. Three bytes cover MAX_MESSAGE_SIZE.
+    const std::size_t kLengthBytes = 3;
+
+    std::size_t beginFrame(std::vector<std::uint8_t>& out, MessageType type) {
+        const std::size_t start = out.size();
+        out.resize(start + kLengthBytes);
+        out.push_back(static_cast<std::uint8_t>(type));
+        return start;
+    }
+
+    void endFrame(std::vector<std::uint8_t>& out, std::size_t start) {
+        std::size_t length = out.size() - start - kLengthBytes;
+        for (std::size_t i = 0; i < kLengthBytes; ++i) {
+            out[start + i] = static_cast<std::uint8_t>((length & 0x7F) | (i + 1 < kLengthBytes ? 0x80 : 0));
+            length >>= 7;
+        }
+    }
+
+    void putString(std::vector<std::uint8_t>& out, const std::string& text) {
+        Varint::put(out, text.size());
+        out.insert(out.end(), text.begin(), text.end());
+    }
+
+    bool getString(const std::uint8_t* in, std::size_t size, std::size_t& offset, std::string& text) {
+        std::uint64_t length;
+        if (!Varint::get(in, size, offset, length) || length > size - offset) {
+            return false;
+        }
+        text.assign(reinterpret_cast<const char*>(in) + offset, static_cast<std::size_t>(length));
+        offset += static_cast<std::size_t>(length);
+        return true;
+    }
+
+    std::uint32_t toWireScore(float score) {
+        return score > 0.0f ? static_cast<std::uint32_t>(std::min(score, 4.0e9f)) : 0;
+    }
+
+    void encodeSubmit(std::vector<std::uint8_t>& out, const std::string& name, std::uint32_t score, std::uint32_t coins) {
+        const std::size_t start = beginFrame(out, MessageType::SUBMIT);
+        Varint::put(out, score);
+        Varint::put(out, coins);
+        putString(out, name.size() > Leaderboard::MAX_NAME_LENGTH ? name.substr(0, Leaderboard::MAX_NAME_LENGTH) : name);
+        endFrame(out, start);
+    }
+
+    void encodeQuery(std::vector<std::uint8_t>& out, std::uint64_t requestId, std::uint32_t score, std::size_t topCount) {
+        const std::size_t start = beginFrame(out, MessageType::QUERY);
+        Varint::put(out, requestId);
+        Varint::put(out, score);
+        Varint::put(out, topCount);
+        endFrame(out, start);
+    }
+
+    bool decodeStanding(const std::uint8_t* in, std::size_t size, std::uint64_t& requestId, LeaderboardStanding& standing) {
+        std::size_t offset = 1;
+        std::uint64_t score, count;
+        if (!Varint::get(in, size, offset, requestId) || !Varint::get(in, size, offset, score) ||
+            !Varint::get(in, size, offset, standing.rank) || !Varint::get(in, size, offset, standing.total) ||
+            !Varint::get(in, size, offset, count) || count > Leaderboard::DEFAULT_TOP_SIZE) {
+            return false;
+        }
+        standing.score = static_cast<std::uint32_t>(score);
+        standing.top.resize(static_cast<std::size_t>(count));
+        for (LeaderboardEntry& entry : standing.top) {
+            std::uint64_t entryScore;
+            if (!Varint::get(in, size, offset, entryScore) || !getString(in, size, offset, entry.name)) {
+                return false;
+            }
+            entry.score = static_cast<std::uint32_t>(entryScore);
+            entry.coins = 0;
+        }
+        return offset == size;
+    }
+
+    // Hands every whole message in 'buffer' to handle(body, size) and keeps
+    // the incomplete tail. Returns false on a malformed frame or if handle()
+    // rejects a message.
+    template <typename Handle> bool drainFrames(std::vector<std::uint8_t>& buffer, Handle handle) {
+        std::size_t offset = 0;
+        bool ok = true;
+        while (offset < buffer.size()) {
+            std::size_t cursor = offset;
+            std::uint64_t length;
+            if (!Varint::get(buffer.data(), buffer.size(), cursor, length)) {
+                ok = buffer.size() - offset < kLengthBytes;
+                break;
+            }
+            if (length == 0 || length > MAX_MESSAGE_SIZE) {
+                ok = false;
+                break;
+            }
+            if (buffer.size() - cursor < length) {
+                break;
+            }
+            if (!handle(buffer.data() + cursor, static_cast<std::size_t>(length))) {
+                ok = false;
+                break;
+            }
+            offset = cursor + static_cast<std::size_t>(length);
+        }
+        buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(offset));
+        return ok;
+    }
+
+    // Reads from a blocking socket until one whole message is in 'buffer'.
+    template <typename Handle> bool receiveOne(sf::TcpSocket& socket, std::vector<std::uint8_t>& buffer, Handle handle) {
+        bool handled = false;
+        std::uint8_t chunk[4096];
+        while (!handled) {
+            bool ok = drainFrames(buffer, [&](const std::uint8_t* data, std::size_t size) {
+                handled = true;
+                return handle(data, size);
+            });
+            if (!ok) {
+                return false;
+            }
+            if (handled) {
+                break;
+            }
+            std::size_t received = 0;
+            if (socket.receive(chunk, sizeof(chunk), received) != sf::Socket::Done) {
+                return false;
+            }
+            buffer.insert(buffer.end(), chunk, chunk + received);
+        }
+        return true;
+    }
+
+    double percentile(const std::vector<double>& sorted, double fraction) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        const std::size_t index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size()));
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+// ---------------------------------------------------------
+// DAEMON
+// ---------------------------------------------------------
+
+LeaderboardServer::LeaderboardServer(std::size_t topSize) : mBoard(topSize) {
+    mBatch.reserve(1024);
+}
+
+bool LeaderboardServer::open(const std::filesystem::path& logPath) {
+    return logPath.empty() || mBoard.open(logPath);
+}
+
+bool LeaderboardServer::listen(unsigned short port, const sf::IpAddress& address) {
+    mListener.setBlocking(false);
+    if (mListener.listen(port, address) != sf::Socket::Done) {
+        return false;
+    }
+    mSelector.add(mListener);
+    return true;
+}
+
+void LeaderboardServer::acceptClients() {
+    while (mClients.size() < MAX_CLIENTS) {
+        auto socket = std::make_unique<sf::TcpSocket>();
+        if (mListener.accept(*socket) != sf::Socket::Done) {
+            return;
+        }
+        socket->setBlocking(false);
+        mSelector.add(*socket);
+        Client client;
+        client.socket = std::move(socket);
+        mClients.push_back(std::move(client));
+    }
+}
+
+void LeaderboardServer::receive(std::size_t index) {
+    Client& client = mClients[index];
+    std::uint8_t chunk[16384];
+    // A few reads per round so one chatty cabinet cannot starve the rest
+    for (int reads = 0; reads < 4; ++reads) {
+        std::size_t received = 0;
+        const sf::Socket::Status status = client.socket->receive(chunk, sizeof(chunk), received);
+        if (status == sf::Socket::Disconnected || status == sf::Socket::Error) {
+            client.dropped = true;
+            break;
+        }
+        if (status != sf::Socket::Done) {
+            break;
+        }
+        client.in.insert(client.in.end(), chunk, chunk + received);
+    }
+    const bool ok = drainFrames(client.in,
+        [this, index](const std::uint8_t* data, std::size_t size) { return handle(index, data, size); });
+    if (!ok) {
+        client.dropped = true;
+    }
+}
+
+bool LeaderboardServer::handle(std::size_t index, const std::uint8_t* data, std::size_t size) {
+    std::size_t offset = 1;
+    if (data[0] == static_cast<std::uint8_t>(MessageType::SUBMIT)) {
+        std::uint64_t score, coins;
+        LeaderboardEntry entry;
+        if (!Varint::get(data, size, offset, score) || !Varint::get(data, size, offset, coins) ||
+            !getString(data, size, offset, entry.name) || offset != size) {
+            return false;
+        }
+        entry.score = static_cast<std::uint32_t>(score);
+        entry.coins = static_cast<std::uint32_t>(coins);
+        mBatch.push_back(std::move(entry));
+        return true;
+    }
+    if (data[0] == static_cast<std::uint8_t>(MessageType::QUERY)) {
+        PendingQuery query{ index, 0, 0, 0 };
+        std::uint64_t score, topCount;
+        if (!Varint::get(data, size, offset, query.requestId) || !Varint::get(data, size, offset, score) ||
+            !Varint::get(data, size, offset, topCount) || offset != size) {
+            return false;
+        }
+        query.score = static_cast<std::uint32_t>(score);
+        query.topCount = static_cast<std::size_t>(std::min<std::uint64_t>(topCount, Leaderboard::DEFAULT_TOP_SIZE));
+        mQueries.push_back(query);
+        return true;
+    }
+    return false;
+}
+
+void LeaderboardServer::flush(Client& client) {
+    if (client.sentOffset < client.out.size()) {
+        std::size_t sent = 0;
+        const sf::Socket::Status status =
+            client.socket->send(client.out.data() + client.sentOffset, client.out.size() - client.sentOffset, sent);
+        if (status == sf::Socket::Disconnected || status == sf::Socket::Error) {
+            client.dropped = true;
+            return;
+        }
+        client.sentOffset += sent;
+    }
+    if (client.sentOffset == client.out.size()) {
+        client.out.clear();
+        client.sentOffset = 0;
+    }
+    else if (client.out.size() - client.sentOffset > MAX_BACKLOG) {
+        client.dropped = true; // not reading its replies
+    }
+}
+
+void LeaderboardServer::poll(sf::Time timeout) {
+    if (mSelector.wait(timeout)) {
+        if (mSelector.isReady(mListener)) {
+            acceptClients();
+        }
+        for (std::size_t i = 0; i < mClients.size(); ++i) {
+            if (!mClients[i].dropped && mSelector.isReady(*mClients[i].socket)) {
+                receive(i);
+            }
+        }
+    }
+
+    // Group commit: everything submitted this round goes in as one batch,
+    // before any of this round's queries are answered
+    mSubmissions += mBatch.size();
+    mBoard.commit(mBatch);
+
+    const std::vector<LeaderboardEntry>& top = mBoard.getTop();
+    for (const PendingQuery& query : mQueries) {
+        Client& client = mClients[query.client];
+        if (client.dropped) {
+            continue;
+        }
+        const std::size_t start = beginFrame(client.out, MessageType::STANDING);
+        Varint::put(client.out, query.requestId);
+        Varint::put(client.out, query.score);
+        Varint::put(client.out, mBoard.rankOf(query.score));
+        Varint::put(client.out, mBoard.size());
+        const std::size_t count = std::min(query.topCount, top.size());
+        Varint::put(client.out, count);
+        for (std::size_t i = 0; i < count; ++i) {
+            Varint::put(client.out, top[i].score);
+            putString(client.out, top[i].name);
+        }
+        endFrame(client.out, start);
+    }
+    mQueryCount += mQueries.size();
+    mQueries.clear();
+
+    for (Client& client : mClients) {
+        if (!client.dropped) {
+            flush(client);
+        }
+        if (client.dropped) {
+            mSelector.remove(*client.socket);
+        }
+    }
+    mClients.erase(std::remove_if(mClients.begin(), mClients.end(), [](const Client& client) { return client.dropped; }),
+        mClients.end());
+}
+
+bool runLeaderboardDaemon(unsigned short port, const std::filesystem::path& logPath, std::ostream& out,
+    float reportSeconds) {
+    LeaderboardServer server;
+    if (!server.open(logPath)) {
+        out << "Could not open " << logPath.string() << " for appending\n";
+        return false;
+    }
+    if (!server.listen(port)) {
+        out << "Could not listen on port " << port << "\n";
+        return false;
+    }
+    out << "Leaderboard on " << sf::IpAddress::LocalHost.toString() << ":" << port << ", " << server.getBoard().size() << " scores loaded" << std::endl;
+
+    sf::Clock report;
+    std::uint64_t lastSubmissions = 0;
+    std::uint64_t lastQueries = 0;
+    std::uint64_t lastBatches = server.getBoard().getBatchCount();
+    while (true) {
+        server.poll(sf::milliseconds(100));
+        const float elapsed = report.getElapsedTime().asSeconds();
+        if (elapsed < reportSeconds) {
+            continue;
+        }
+        const std::uint64_t submissions = server.getSubmissionCount() - lastSubmissions;
+        const std::uint64_t batches = server.getBoard().getBatchCount() - lastBatches;
+        out << server.getClientCount() << " cabinets, " << submissions / elapsed << " submissions/s, "
+            << (server.getQueryCount() - lastQueries) / elapsed << " queries/s, "
+            << (batches > 0 ? static_cast<double>(submissions) / static_cast<double>(batches) : 0.0)
+            << " per batch, " << server.getBoard().size() << " scores" << std::endl;
+        lastSubmissions = server.getSubmissionCount();
+        lastQueries = server.getQueryCount();
+        lastBatches = server.getBoard().getBatchCount();
+        report.restart();
+    }
+}
+
+// ---------------------------------------------------------
+// CABINET CLIENT
+// ---------------------------------------------------------
+
+LeaderboardClient::LeaderboardClient(const std::string& host, unsigned short port)
+    : mHost(host), mPort(port), mWorker(&LeaderboardClient::run, this) {}
+
+LeaderboardClient::~LeaderboardClient() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_one();
+    mWorker.join();
+}
+
+void LeaderboardClient::submit(const std::string& name, float score, int coins) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        encodeSubmit(mOutgoing, name, toWireScore(score), static_cast<std::uint32_t>(std::max(coins, 0)));
+        encodeQuery(mOutgoing, mNextRequest++, toWireScore(score), TOP_COUNT);
+    }
+    mWake.notify_one();
+}
+
+void LeaderboardClient::query(float score) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        encodeQuery(mOutgoing, mNextRequest++, toWireScore(score), TOP_COUNT);
+    }
+    mWake.notify_one();
+}
+
+bool LeaderboardClient::pollStanding(LeaderboardStanding& standing) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mHasStanding) {
+        return false;
+    }
+    std::swap(standing, mStanding);
+    mHasStanding = false;
+    return true;
+}
+
+void LeaderboardClient::run() {
+    // Results kept while the daemon is down; past this the oldest are lost
+    const std::size_t kMaxQueued = 256 * 1024;
+    const sf::Time kRetryDelay = sf::seconds(2.0f);
+
+    sf::TcpSocket socket;
+    sf::SocketSelector selector;
+    std::vector<std::uint8_t> sending;
+    std::vector<std::uint8_t> incoming;
+    std::uint8_t chunk[4096];
+    bool connected = false;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            if (!connected) {
+                // Only worth connecting with something to say
+                mWake.wait_for(lock, std::chrono::milliseconds(kRetryDelay.asMilliseconds()),
+                    [this, &sending] { return mStop || !mOutgoing.empty() || !sending.empty(); });
+            }
+            if (mStop) {
+                return;
+            }
+            sending.insert(sending.end(), mOutgoing.begin(), mOutgoing.end());
+            mOutgoing.clear();
+        }
+
+        if (!connected) {
+            if (sending.empty()) {
+                continue;
+            }
+            if (sending.size() > kMaxQueued) {
+                sending.clear();
+            }
+            if (socket.connect(sf::IpAddress(mHost), mPort, kRetryDelay) != sf::Socket::Done) {
+                socket.disconnect();
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait_for(lock, std::chrono::milliseconds(kRetryDelay.asMilliseconds()), [this] { return mStop; });
+                continue;
+            }
+            connected = true;
+            mConnected = true;
+            incoming.clear();
+            selector.add(socket);
+        }
+
+        // Blocking I/O is fine here: only this thread waits on it
+        bool lost = !sending.empty() && socket.send(sending.data(), sending.size()) != sf::Socket::Done;
+        sending.clear();
+        if (!lost && selector.wait(sf::milliseconds(50))) {
+            std::size_t received = 0;
+            lost = socket.receive(chunk, sizeof(chunk), received) != sf::Socket::Done;
+            incoming.insert(incoming.end(), chunk, chunk + received);
+            lost = !drainFrames(incoming, [this](const std::uint8_t* data, std::size_t size) {
+                LeaderboardStanding standing;
+                std::uint64_t requestId;
+                if (data[0] != static_cast<std::uint8_t>(MessageType::STANDING) ||
+                    !decodeStanding(data, size, requestId, standing)) {
+                    return false;
+                }
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStanding = std::move(standing);
+                mHasStanding = true;
+                return true;
+            }) || lost;
+        }
+        if (lost) {
+            selector.remove(socket);
+            socket.disconnect();
+            connected = false;
+            mConnected = false;
+        }
+    }
+}
+
+// ---------------------------------------------------------
+// LOAD TEST
+// ---------------------------------------------------------
+
+bool runLeaderboardLoadTest(const LeaderboardLoadConfig& config, std::ostream& out) {
+    const std::size_t connections = std::max<std::size_t>(1, std::min(config.connections, config.submitters));
+    unsigned int threads = config.threads > 0 ? config.threads : std::thread::hardware_concurrency();
+    threads = static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(threads > 0 ? threads : 1, connections)));
+
+    std::vector<std::unique_ptr<sf::TcpSocket>> sockets;
+    for (std::size_t i = 0; i < connections; ++i) {
+        auto socket = std::make_unique<sf::TcpSocket>();
+        if (socket->connect(sf::IpAddress(config.host), config.port, sf::seconds(5.0f)) != sf::Socket::Done) {
+            out << "Could not connect to " << config.host << ":" << config.port << "\n";
+            return false;
+        }
+        sockets.push_back(std::move(socket));
+    }
+
+    // Thread t drives connections t, t + threads, ...; connection c speaks
+    // for submitters c, c + connections, ...
+    std::vector<std::vector<double>> latencies(threads);
+    std::atomic<bool> failed{ false };
+    auto drive = [&](unsigned int thread) {
+        std::mt19937 rng(1000 + thread);
+        std::exponential_distribution<float> scoreDist(1.0f / 800.0f);
+        std::vector<std::uint8_t> message;
+        std::vector<std::uint8_t> incoming;
+        std::vector<std::string> names;
+        for (std::size_t round = 0; round < config.rounds && !failed; ++round) {
+            for (std::size_t c = thread; c < connections && !failed; c += threads) {
+                message.clear();
+                for (std::size_t s = c; s < config.submitters; s += connections) {
+                    const float score = scoreDist(rng);
+                    encodeSubmit(message, "cabinet-" + std::to_string(s), toWireScore(score),
+                        static_cast<std::uint32_t>(score / 50.0f));
+                }
+                const std::uint32_t probe = toWireScore(scoreDist(rng));
+                encodeQuery(message, round, probe, 0);
+
+                sf::Clock clock;
+                if (sockets[c]->send(message.data(), message.size()) != sf::Socket::Done ||
+                    !receiveOne(*sockets[c], incoming, [](const std::uint8_t* data, std::size_t) {
+                        return data[0] == static_cast<std::uint8_t>(MessageType::STANDING);
+                    })) {
+                    failed = true;
+                    break;
+                }
+                latencies[thread].push_back(clock.getElapsedTime().asMicroseconds() / 1000.0);
+            }
+        }
+    };
+
+    sf::Clock clock;
+    std::vector<std::thread> pool;
+    for (unsigned int t = 0; t < threads; ++t) {
+        pool.emplace_back(drive, t);
+    }
+    for (std::thread& worker : pool) {
+        worker.join();
+    }
+    // Every connection's last query came back after its last submission was
+    // committed, so the whole load has landed by now
+    const float seconds = clock.getElapsedTime().asSeconds();
+    if (failed) {
+        out << "The daemon dropped the connection\n";
+        return false;
+    }
+
+    std::vector<double> all;
+    for (const std::vector<double>& part : latencies) {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    std::sort(all.begin(), all.end());
+    const std::size_t submissions = config.submitters * config.rounds;
+    out << "Submitters: " << config.submitters << " over " << connections << " connections, " << threads
+        << " threads, " << config.rounds << " rounds\n"
+        << "Submissions: " << submissions << " in " << seconds << " s ("
+        << (seconds > 0.0f ? static_cast<double>(submissions) / seconds : 0.0) << "/s)\n"
+        << "Rank queries: " << all.size() << ", latency p50 " << percentile(all, 0.50) << " ms, p99 "
+        << percentile(all, 0.99) << " ms, max " << (all.empty() ? 0.0 : all.back()) << " ms\n";
+    return true;
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include "Leaderboard.h"
+#include <SFML/Network.hpp>
+#include <SFML/System/Time.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loopback TCP protocol between cabinets and the leaderboard daemon. Every
+// message is framed by its varint byte length and starts with a type byte:
+//
+//   SUBMIT    varint score, varint coins, varint name length, name
+//   QUERY     varint request id, varint score, varint top count
+//   STANDING  varint request id, varint rank of the queried score,
+//             varint total scores, varint entry count, then per entry
+//             varint score and varint name length + name
+//
+// Submissions are not acknowledged. A QUERY is answered after every
+// submission that arrived before it has been committed.
+namespace LeaderboardProtocol {
+    enum class MessageType : std::uint8_t { SUBMIT = 1, QUERY, STANDING };
+
+    constexpr unsigned short DEFAULT_PORT = 47100;
+    constexpr std::size_t MAX_MESSAGE_SIZE = 64 * 1024;
+}
+
+// What the daemon said about one queried score.
+struct LeaderboardStanding {
+    std::uint32_t score = 0; // the score that was queried
+    std::uint64_t rank = 0;
+    std::uint64_t total = 0;
+    std::vector<LeaderboardEntry> top;
+};
+
+// The daemon. Each poll() is one group-commit round: it reads everything
+// every subscriber has sent, commits all the submissions as one batch, then
+// answers the queries from that round. Under load the batches simply grow.
+class LeaderboardServer {
+public:
+    static constexpr std::size_t MAX_CLIENTS = 512;
+    static constexpr std::size_t MAX_BACKLOG = 1024 * 1024;
+
+    explicit LeaderboardServer(std::size_t topSize = Leaderboard::DEFAULT_TOP_SIZE);
+
+    // Replays and then appends to the log at 'logPath' (empty = memory only).
+    bool open(const std::filesystem::path& logPath);
+    // Loopback only unless a wider 'address' is asked for explicitly.
+    bool listen(unsigned short port, const sf::IpAddress& address = sf::IpAddress::LocalHost);
+
+    // Waits up to 'timeout' for traffic and runs one round.
+    void poll(sf::Time timeout);
+
+    const Leaderboard& getBoard() const { return mBoard; }
+    std::uint64_t getSubmissionCount() const { return mSubmissions; }
+    std::uint64_t getQueryCount() const { return mQueryCount; }
+    std::size_t getClientCount() const { return mClients.size(); }
+
+private:
+    struct Client {
+        std::unique_ptr<sf::TcpSocket> socket;
+        std::vector<std::uint8_t> in; // bytes of an incomplete message
+        std::vector<std::uint8_t> out;
+        std::size_t sentOffset = 0;
+        bool dropped = false;
+    };
+
+    struct PendingQuery {
+        std::size_t client;
+        std::uint64_t requestId;
+        std::uint32_t score;
+        std::size_t topCount;
+    };
+
+    void acceptClients();
+    void receive(std::size_t index);
+    bool handle(std::size_t index, const std::uint8_t* data, std::size_t size);
+    void flush(Client& client);
+
+    Leaderboard mBoard;
+    sf::TcpListener mListener;
+    sf::SocketSelector mSelector;
+    std::vector<Client> mClients;
+    std::vector<LeaderboardEntry> mBatch;
+    std::vector<PendingQuery> mQueries;
+    std::uint64_t mSubmissions = 0;
+    std::uint64_t mQueryCount = 0;
+};
+
+// Cabinet side. All socket work happens on a background thread, so
+// submit() and pollStanding() only touch a queue under a mutex and never
+// wait on the network; results are queued while the daemon is unreachable.
+class LeaderboardClient {
+public:
+    LeaderboardClient(const std::string& host, unsigned short port);
+    ~LeaderboardClient();
+    LeaderboardClient(const LeaderboardClient&) = delete;
+    LeaderboardClient& operator=(const LeaderboardClient&) = delete;
+
+    // Sends a finished run and asks where it ranks.
+    void submit(const std::string& name, float score, int coins);
+    // Asks for the current top entries and the rank 'score' would have.
+    void query(float score);
+
+    // Takes the newest standing the daemon sent, if one arrived since the
+    // last call.
+    bool pollStanding(LeaderboardStanding& standing);
+    bool isConnected() const { return mConnected; }
+
+    static constexpr std::size_t TOP_COUNT = 5; // entries asked for per query
+
+private:
+    void run();
+
+    std::string mHost;
+    unsigned short mPort;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::vector<std::uint8_t> mOutgoing; // encoded messages not yet handed to the worker
+    LeaderboardStanding mStanding;
+    bool mHasStanding = false;
+    bool mStop = false;
+    std::uint64_t mNextRequest = 1;
+    std::atomic<bool> mConnected{ false };
+    std::thread mWorker;
+};
+
+// Serves the board on loopback 'port' until the process is killed, printing
+// throughput every 'reportSeconds'. Returns false if it cannot start.
+bool runLeaderboardDaemon(unsigned short port, const std::filesystem::path& logPath, std::ostream& out,
+    float reportSeconds = 10.0f);
+
+struct LeaderboardLoadConfig {
+    std::string host = "localhost";
+    unsigned short port = LeaderboardProtocol::DEFAULT_PORT;
+    std::size_t submitters = 2000;
+    std::size_t connections = 64; // submitters share these
+    unsigned int threads = 0; // 0 = one per hardware thread
+    std::size_t rounds = 10; // submissions per submitter
+};
+
+// Plays 'submitters' cabinets against a running daemon: every round each
+// submitter sends one result and each connection times one rank query.
+// Prints submissions per second and the rank-query latency percentiles.
+// Returns false if it could not connect.
+bool runLeaderboardLoadTest(const LeaderboardLoadConfig& config, std::ostream& out);
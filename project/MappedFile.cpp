@@ -0,0 +1,72 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::filesystem::path& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+        CloseHandle(file);
+        return false;
+    }
+    // The view keeps the mapping and the file open on its own
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) {
+        return false;
+    }
+    mSize = static_cast<std::size_t>(size.QuadPart);
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size <= 0) {
+        ::close(file);
+        return false;
+    }
+    // The mapping keeps the file open on its own
+    void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    mSize = static_cast<std::size_t>(info.st_size);
+#endif
+    mData = static_cast<const std::uint8_t*>(view);
+    return true;
+}
+
+void MappedFile::close() {
+    if (!mData) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mData);
+#else
+    munmap(const_cast<std::uint8_t*>(mData), mSize);
+#endif
+    mData = nullptr;
+    mSize = 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// A whole file mapped read-only into memory. Opening costs the same for any
+// size: the OS reads pages in on first touch and shares them between
+// processes mapping the same file.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    // Returns false for a missing, unreadable or empty file.
+    bool open(const std::filesystem::path& path);
+    void close();
+
+    bool isOpen() const { return mData != nullptr; }
+    const std::uint8_t* data() const { return mData; }
+    std::size_t size() const { return mSize; }
+
+private:
+    const std::uint8_t* mData = nullptr;
+    std::size_t mSize = 0;
+};
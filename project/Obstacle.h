@@ -1,12 +1,32 @@
-#pragma once
-#include "GameObject.h"
-#include "Player.h"
-
-enum class ObstacleType { TRAIN, BARRIER, CONE, FENCE };
-
-class Obstacle : public GameObject {
-public:
-	virtual bool onCollision(Player& player) = 0; // return true if collision should end the game
-	virtual ObstacleType getType() const = 0;
-};
-#pragma once
+#pragma once
+#pragma once
+#include "EntityRegistry.h"
+#include "Player.h"
+#include <SFML/Graphics/Rect.hpp>
+#include <cstdint>
+
+enum class ObstacleType { TRAIN, BARRIER, CONE, FENCE };
+
+// Ways past an obstacle without a power-up, as flags. Track generation
+// uses them to keep every layout passable (see LaneGrid).
+enum ObstacleClearance : std::uint8_t { CLEAR_NONE = 0, CLEAR_BY_JUMP = 1, CLEAR_BY_SLIDE = 2 };
+
+// Static description of an obstacle kind. Obstacles themselves are plain rows
+// in the EntityWorld; their behaviour is looked up from the type.
+struct ObstacleSpec {
+	ObstacleType type;
+	const char* name;
+	float width;
+	float height;
+	float spawnWeight; // relative chance of being picked for a single-obstacle spawn
+	std::uint8_t clearance; // ObstacleClearance flags
+	bool (*onCollision)(const Player& player, const sf::FloatRect& bounds); // return true if collision should end the game
+};
+
+template <> struct KindTraits<ObstacleType> {
+	using Spec = ObstacleSpec;
+
+	template <typename T> static constexpr ObstacleSpec describe() {
+		return { T::TYPE, T::NAME, T::WIDTH, T::HEIGHT, T::SPAWN_WEIGHT, T::CLEARANCE, &T::onCollision };
+	}
+};
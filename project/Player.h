@@ -1,67 +1,90 @@
-#pragma once
-#include "LaneSystem.h"
-#pragma once
-#include "LaneSystem.h"
-#include <SFML/Graphics.hpp>
-
-enum class PlayerState { RUNNING, JUMPING, SLIDING };
-
-class Player {
-public:
-    Player();
-
-    void update(sf::Time dt);
-    void draw(sf::RenderWindow& window);
-
-    void moveLeft();
-    void moveRight();
-    void jump();
-    void slide();
-
-    sf::FloatRect getBounds() const;
-    PlayerState getState() const { return mState; }
-    int getLane() const { return mLane; }
-	bool isRunning() const { return mState == PlayerState::RUNNING; }
-	bool isJumping() const { return mState == PlayerState::JUMPING; }
-	bool isSliding() const { return mState == PlayerState::SLIDING; }
-
-    void setInvincible(bool invincible) { mIsInvincible = invincible; }
-    bool isInvincible() const { return mIsInvincible; }
-
-    void activateMagnet(float duration) { mMagnetTimer = duration; }
-    bool isMagnetActive() const { return mMagnetTimer > 0; }
-
-    void activateDoubleCoin(float duration) { mDoubleCoinTimer = duration; }
-    bool isDoubleCoinActive() const { return mDoubleCoinTimer > 0; }
-
-    void activateShield(float duration) {
-        mInvincibleTimer = duration;
-        mIsInvincible = true;
-    }
-
-private:
-    sf::RectangleShape mShape;
-    int mLane; // 0, 1, 2
-    float mCurrentX;
-
-    PlayerState mState;
-    float mVerticalVelocity;
-    float mGroundY;
-
-    // Jump constants
-    const float GRAVITY = 1500.0f;
-    const float JUMP_FORCE = -800.0f;
-
-    // Slide constants
-    float mSlideTimer;
-    const float SLIDE_DURATION = 1.0f;
-
-    // Movement smoothing
-    const float LANE_SWITCH_SPEED = 15.0f;
-
-    bool mIsInvincible;
-    float mInvincibleTimer;
-    float mMagnetTimer;
-    float mDoubleCoinTimer;
-};
-#pragma once
+#pragma once
+#include "LaneSystem.h"
+#pragma once
+#include "LaneSystem.h"
+#include "PlayerEffects.h"
+#include "Snapshot.h"
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/System/Vector2.hpp>
+
+enum class PlayerState { RUNNING, JUMPING, SLIDING };
+
+// The runner's state and movement rules. Plain data with no SFML shape;
+// WorldRenderer draws it from getPosition()/getSize().
+class Player {
+public:
+    Player();
+
+    void update(sf::Time dt);
+
+    void moveLeft();
+    void moveRight();
+    void jump();
+    void slide();
+
+    sf::FloatRect getBounds() const;
+    // Bounds at the start of the last update(), for swept collision tests.
+    sf::FloatRect getPreviousBounds() const { return mPreviousBounds; }
+    // Bottom centre of the player, now and at the start of the last update().
+    sf::Vector2f getPosition() const { return mPosition; }
+    sf::Vector2f getPreviousPosition() const { return mPreviousPosition; }
+    sf::Vector2f getSize() const { return mSize; }
+    PlayerState getState() const { return mState; }
+    int getLane() const { return mLane; }
+    float getGroundY() const { return mGroundY; }
+	bool isRunning() const { return mState == PlayerState::RUNNING; }
+	bool isJumping() const { return mState == PlayerState::JUMPING; }
+	bool isSliding() const { return mState == PlayerState::SLIDING; }
+
+    // Starts a timed effect, or re-applies a running one by its stacking
+    // rule. The effect's onEnter runs only when it was not running.
+    void applyEffect(EffectType type, float duration);
+    const EffectStack& getEffects() const { return mEffects; }
+
+    // True once after any effect started or ended since the last call;
+    // state kept elsewhere (the score multiplier) is re-read only then.
+    bool takeEffectChanges();
+
+    // Effect-driven state, set by the effects' enter and exit hooks.
+    void setInvincible(bool invincible) { mIsInvincible = invincible; }
+    bool isInvincible() const { return mIsInvincible; }
+    void setMagnet(bool active) { mIsMagnetActive = active; }
+    bool isMagnetActive() const { return mIsMagnetActive; }
+    void setCoinMultiplier(int multiplier) { mCoinMultiplier = multiplier; }
+    int getCoinMultiplier() const { return mCoinMultiplier; }
+    bool isDoubleCoinActive() const { return mCoinMultiplier > 1; }
+
+    void saveState(SnapshotWriter& writer) const;
+    bool loadState(SnapshotReader& reader);
+
+private:
+    sf::Vector2f mPosition; // bottom centre
+    sf::Vector2f mSize;
+    sf::FloatRect mPreviousBounds;
+    sf::Vector2f mPreviousPosition;
+    int mLane; // 0, 1, 2
+    float mCurrentX;
+
+    PlayerState mState;
+    float mVerticalVelocity;
+    float mGroundY;
+
+    // Jump constants
+    static constexpr float GRAVITY = 1500.0f;
+    static constexpr float JUMP_FORCE = -800.0f;
+
+    // Slide constants
+    float mSlideTimer;
+    static constexpr float SLIDE_DURATION = 1.0f;
+
+    // Movement smoothing
+    static constexpr float LANE_SWITCH_SPEED = 15.0f;
+
+    EffectStack mEffects;
+    bool mEffectsChanged;
+    bool mIsInvincible;
+    bool mIsMagnetActive;
+    int mCoinMultiplier;
+};
+#pragma once
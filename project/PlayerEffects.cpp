@@ -0,0 +1,79 @@
+#include "PlayerEffects.h"
+#include "Player.h"
+#include <algorithm>
+
+namespace {
+    // The shield and the jetpack both make the player invincible; it ends
+    // when the last of them does
+    void startInvincibility(Player& player) { player.setInvincible(true); }
+
+    void endInvincibility(Player& player) {
+        const EffectStack& effects = player.getEffects();
+        player.setInvincible(effects.isActive(EffectType::SHIELD) || effects.isActive(EffectType::JETPACK));
+    }
+
+    void startFlight(Player& player) {
+        startInvincibility(player);
+        player.jump();
+    }
+
+    void startMagnet(Player& player) { player.setMagnet(true); }
+    void endMagnet(Player& player) { player.setMagnet(false); }
+
+    void startDoubleCoins(Player& player) { player.setCoinMultiplier(2); }
+    void endDoubleCoins(Player& player) { player.setCoinMultiplier(1); }
+
+    // In EffectType order
+    const EffectSpec EFFECT_SPECS[] = {
+        { EffectType::SHIELD, "shield", EffectStacking::REFRESH, &startInvincibility, &endInvincibility },
+        { EffectType::JETPACK, "jetpack", EffectStacking::REFRESH, &startFlight, &endInvincibility },
+        { EffectType::MAGNET, "magnet", EffectStacking::REFRESH, &startMagnet, &endMagnet },
+        { EffectType::DOUBLE_COIN, "doubleCoin", EffectStacking::REFRESH, &startDoubleCoins, &endDoubleCoins },
+    };
+    static_assert(sizeof(EFFECT_SPECS) / sizeof(EFFECT_SPECS[0]) == static_cast<std::size_t>(EffectType::COUNT),
+        "every EffectType needs a spec");
+}
+
+const EffectSpec& getEffectSpec(EffectType type) { return EFFECT_SPECS[static_cast<std::size_t>(type)]; }
+
+bool EffectStack::push(EffectType type, float duration, EffectStacking stacking) {
+    for (std::size_t i = 0; i < mCount; ++i) {
+        Entry& entry = mEntries[i];
+        if (entry.type != type) {
+            continue;
+        }
+        entry.stacking = stacking;
+        switch (stacking) {
+        case EffectStacking::REFRESH:
+            entry.remaining = duration;
+            break;
+        case EffectStacking::EXTEND:
+            entry.remaining += duration;
+            break;
+        case EffectStacking::KEEP_LONGEST:
+            entry.remaining = std::max(entry.remaining, duration);
+            break;
+        }
+        return false;
+    }
+    if (duration <= 0.0f) {
+        return false;
+    }
+    // One entry per effect type, so there is always room
+    mEntries[mCount++] = Entry{ type, stacking, duration };
+    return true;
+}
+
+float EffectStack::getRemaining(EffectType type) const {
+    const Entry* entry = find(type);
+    return entry ? entry->remaining : 0.0f;
+}
+
+const EffectStack::Entry* EffectStack::find(EffectType type) const {
+    for (std::size_t i = 0; i < mCount; ++i) {
+        if (mEntries[i].type == type) {
+            return &mEntries[i];
+        }
+    }
+    return nullptr;
+}
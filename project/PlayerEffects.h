@@ -0,0 +1,87 @@
+#pragma once
+#include "Snapshot.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+class Player;
+
+// Timed effects a power-up can put on the player, one entry each in the
+// spec table. New effects are added here and in PlayerEffects.cpp.
+enum class EffectType : std::uint8_t { SHIELD, JETPACK, MAGNET, DOUBLE_COIN, COUNT };
+
+// What re-applying an effect that is still running does to its time left.
+enum class EffectStacking : std::uint8_t {
+    REFRESH,      // restart at the new duration
+    EXTEND,       // add the new duration
+    KEEP_LONGEST  // keep whichever is longer
+};
+
+// Static description of an effect. onEnter runs when the effect starts and
+// onExit when it runs out, so player state that depends on it (flags, the
+// coin multiplier) changes only on those transitions.
+struct EffectSpec {
+    EffectType type;
+    const char* name;
+    EffectStacking stacking;
+    void (*onEnter)(Player& player);
+    void (*onExit)(Player& player);
+};
+
+const EffectSpec& getEffectSpec(EffectType type);
+
+// The player's running effects: a fixed-size array of (effect, time left,
+// stacking rule) holding at most one entry per effect, in the order they
+// started. Plain data, so it snapshots and copies with the player, and a
+// tick with no effects running costs one size check.
+class EffectStack {
+public:
+    static constexpr std::size_t CAPACITY = static_cast<std::size_t>(EffectType::COUNT);
+
+    // Starts 'type' or re-applies it by 'stacking'. Returns true if it was
+    // not running before, i.e. the caller should run its onEnter.
+    bool push(EffectType type, float duration, EffectStacking stacking);
+
+    // Counts every running effect down by 'dt' seconds, drops the ones
+    // that run out and then calls onExpire(type) for each of them, so the
+    // callbacks see the stack without them.
+    template <typename Expire> void update(float dt, Expire onExpire) {
+        if (mCount == 0) {
+            return;
+        }
+        std::array<EffectType, CAPACITY> expired;
+        std::size_t expiredCount = 0;
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < mCount; ++i) {
+            mEntries[i].remaining -= dt;
+            if (mEntries[i].remaining > 0.0f) {
+                mEntries[kept++] = mEntries[i];
+            }
+            else {
+                expired[expiredCount++] = mEntries[i].type;
+            }
+        }
+        mCount = static_cast<std::uint8_t>(kept);
+        for (std::size_t i = 0; i < expiredCount; ++i) {
+            onExpire(expired[i]);
+        }
+    }
+
+    bool isActive(EffectType type) const { return find(type) != nullptr; }
+    // Seconds left, or 0 if the effect is not running.
+    float getRemaining(EffectType type) const;
+    std::size_t size() const { return mCount; }
+    void clear() { mCount = 0; }
+
+private:
+    struct Entry {
+        EffectType type;
+        EffectStacking stacking;
+        float remaining;
+    };
+
+    const Entry* find(EffectType type) const;
+
+    std::array<Entry, CAPACITY> mEntries{};
+    std::uint8_t mCount = 0;
+};
@@ -1,12 +1,23 @@
-#pragma once
-#include "GameObject.h"
-#include "Player.h"
-
-enum class PowerUpType { MAGNET, JETPACK, SHIELD, DOUBLE_COIN };
-
-class PowerUp : public GameObject {
-public:
-	virtual void applyEffect(Player& player) = 0;
-	virtual PowerUpType getType() const = 0;
-};
-#pragma once
+#pragma once
+#pragma once
+#include "EntityRegistry.h"
+#include "Player.h"
+
+enum class PowerUpType { MAGNET, JETPACK, SHIELD, DOUBLE_COIN };
+
+// Static description of a power-up kind, looked up from the type.
+struct PowerUpSpec {
+	PowerUpType type;
+	const char* name;
+	float radius;
+	float spawnWeight;
+	void (*applyEffect)(Player& player);
+};
+
+template <> struct KindTraits<PowerUpType> {
+	using Spec = PowerUpSpec;
+
+	template <typename T> static constexpr PowerUpSpec describe() {
+		return { T::TYPE, T::NAME, T::RADIUS, T::SPAWN_WEIGHT, &T::applyEffect };
+	}
+};
@@ -0,0 +1,95 @@
+#include "Replay.h"
+#include "Varint.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    const char kMagic[4] = { 'M', 'R', 'P', 'L' };
+}
+
+Replay::Replay(unsigned int seed, unsigned int tickRate, std::uint64_t chunkHash)
+    : mSeed(seed), mTickRate(tickRate), mChunkHash(chunkHash) {
+    mEvents.reserve(256);
+}
+
+void Replay::record(std::uint64_t tick, PlayerAction action) {
+    Varint::put(mEvents, ((tick - mLastTick) << 2) | static_cast<std::uint64_t>(action));
+    mLastTick = tick;
+    mEventCount++;
+}
+
+bool Replay::save(const std::filesystem::path& path) const {
+    std::vector<std::uint8_t> header(std::begin(kMagic), std::end(kMagic));
+    header.push_back(VERSION);
+    Varint::put(header, mSeed);
+    Varint::put(header, mTickRate);
+    Varint::put(header, mChunkHash);
+    Varint::put(header, mEndTick);
+    Varint::put(header, mChecksum);
+    Varint::put(header, mEventCount);
+    Varint::put(header, mEvents.size());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    file.write(reinterpret_cast<const char*>(mEvents.data()), static_cast<std::streamsize>(mEvents.size()));
+    return static_cast<bool>(file);
+}
+
+void Replay::saveState(SnapshotWriter& writer) const {
+    writer.value(mSeed);
+    writer.value(mTickRate);
+    writer.value(mChunkHash);
+    writer.value(mEndTick);
+    writer.value(mChecksum);
+    writer.value(mLastTick);
+    writer.value<std::uint64_t>(mEventCount);
+    writer.values(mEvents);
+}
+
+bool Replay::loadState(SnapshotReader& reader) {
+    std::uint64_t eventCount = 0;
+    const bool ok = reader.value(mSeed) && reader.value(mTickRate) && reader.value(mChunkHash) &&
+        reader.value(mEndTick) &&
+        reader.value(mChecksum) && reader.value(mLastTick) && reader.value(eventCount) && reader.values(mEvents);
+    mEventCount = static_cast<std::size_t>(eventCount);
+    return ok;
+}
+
+bool Replay::load(const std::filesystem::path& path) {
+    *this = Replay();
+    std::ifstream file(path, std::ios::binary);
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < sizeof(kMagic) + 1 || !std::equal(std::begin(kMagic), std::end(kMagic), bytes.begin()) ||
+        bytes[sizeof(kMagic)] != VERSION) {
+        return false;
+    }
+
+    std::size_t offset = sizeof(kMagic) + 1;
+    std::uint64_t seed, tickRate, chunkHash, endTick, checksum, eventCount, eventBytes;
+    if (!Varint::get(bytes, offset, seed) || !Varint::get(bytes, offset, tickRate) ||
+        !Varint::get(bytes, offset, chunkHash) ||
+        !Varint::get(bytes, offset, endTick) || !Varint::get(bytes, offset, checksum) ||
+        !Varint::get(bytes, offset, eventCount) ||
+        !Varint::get(bytes, offset, eventBytes) || bytes.size() - offset != eventBytes) {
+        return false;
+    }
+
+    Replay loaded(static_cast<unsigned int>(seed), static_cast<unsigned int>(tickRate), chunkHash);
+    loaded.mEndTick = endTick;
+    loaded.mChecksum = checksum;
+    loaded.mEventCount = static_cast<std::size_t>(eventCount);
+    loaded.mEvents.assign(bytes.begin() + static_cast<std::ptrdiff_t>(offset), bytes.end());
+    *this = std::move(loaded);
+    return true;
+}
+
+void Replay::Cursor::advance() {
+    std::uint64_t value;
+    if (!Varint::get(mReplay->mEvents, mOffset, value)) {
+        mDone = true;
+        return;
+    }
+    mTick += value >> 2;
+    mAction = static_cast<PlayerAction>(value & 3);
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "Snapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// Everything the player can press. Actions are applied between ticks, so a
+// run is fully described by its seed, tick rate and (tick, action) pairs.
+enum class PlayerAction : std::uint8_t { MOVE_LEFT, MOVE_RIGHT, JUMP, SLIDE };
+
+// A recorded run. Events are kept encoded as they are recorded: one varint
+// per action holding (ticks since the previous action << 2) | action, so a
+// typical press costs a single byte.
+//
+// File layout: "MRPL", version byte, then varints for seed, tick rate, chunk
+// library hash, end tick, final state checksum, event count and event byte
+// count, then the event bytes.
+class Replay {
+public:
+    static constexpr std::uint8_t VERSION = 4;
+
+    Replay() = default;
+    // 'chunkHash' is the ChunkLibrary::getHash() of the library the run
+    // spawned from (0 = none); playback needs the same library.
+    Replay(unsigned int seed, unsigned int tickRate, std::uint64_t chunkHash = 0);
+
+    // Appends an action taken before tick 'tick' runs. Ticks must not go back.
+    void record(std::uint64_t tick, PlayerAction action);
+    // Marks how many ticks the recorded run lasted.
+    void finish(std::uint64_t endTick) { mEndTick = endTick; }
+    // Stores Simulation::getChecksum() at the end tick (0 = not known).
+    void setChecksum(std::uint64_t checksum) { mChecksum = checksum; }
+
+    unsigned int getSeed() const { return mSeed; }
+    unsigned int getTickRate() const { return mTickRate; }
+    std::uint64_t getChunkHash() const { return mChunkHash; }
+    std::uint64_t getEndTick() const { return mEndTick; }
+    std::uint64_t getChecksum() const { return mChecksum; }
+    std::size_t getEventCount() const { return mEventCount; }
+    std::size_t getEncodedSize() const { return mEvents.size(); }
+
+    bool save(const std::filesystem::path& path) const;
+
+    // The recording so far, for game-state snapshots.
+    void saveState(SnapshotWriter& writer) const;
+    bool loadState(SnapshotReader& reader);
+
+    // Returns false (leaving the replay empty) on a missing, foreign or truncated file.
+    bool load(const std::filesystem::path& path);
+
+    // Walks the events in order.
+    class Cursor {
+    public:
+        explicit Cursor(const Replay& replay) : mReplay(&replay) { advance(); }
+
+        bool done() const { return mDone; }
+        std::uint64_t tick() const { return mTick; }
+        PlayerAction action() const { return mAction; }
+        void next() { advance(); }
+
+    private:
+        void advance();
+
+        const Replay* mReplay;
+        std::size_t mOffset = 0;
+        std::uint64_t mTick = 0;
+        PlayerAction mAction = PlayerAction::MOVE_LEFT;
+        bool mDone = false;
+    };
+
+private:
+    unsigned int mSeed = 0;
+    unsigned int mTickRate = 0;
+    std::uint64_t mChunkHash = 0;
+    std::uint64_t mEndTick = 0;
+    std::uint64_t mChecksum = 0;
+    std::uint64_t mLastTick = 0;
+    std::size_t mEventCount = 0;
+    std::vector<std::uint8_t> mEvents;
+};
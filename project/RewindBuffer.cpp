@@ -0,0 +1,370 @@
+#include "RewindBuffer.h"
+#include "Simulation.h"
+#include "Varint.h"
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+namespace {
+    // A run of this many bytes matching the previous frame ends a literal.
+    const std::size_t kMinMatch = 8;
+    // When a literal has gone this many bytes without the old alignment
+    // coming back, look for a new one (a vector above grew or shrank)...
+    const std::size_t kResyncStride = 16;
+    // ... this far either side of the current one, on a 16 byte anchor
+    const std::ptrdiff_t kResyncWindow = 128;
+    const std::size_t kAnchor = 16;
+    // Bounds the encoder's worst case; past it the rest goes in literally
+    const unsigned int kMaxResyncs = 64;
+    // Runs encoded between looks at the clock
+    const unsigned int kRunsPerClockCheck = 16;
+    // Most bytes the three varints heading a run take
+    const std::size_t kRunHeaderBytes = 30;
+    // Each scratch snapshot gets this share of the byte budget
+    const std::size_t kScratchShare = 16;
+
+    // What a capture is charged, in microseconds: see the class comment.
+    sf::Int64 captureClock() {
+#ifdef _WIN32
+        static const sf::Clock clock;
+        return clock.getElapsedTime().asMicroseconds();
+#else
+        timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return static_cast<sf::Int64>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+#endif
+    }
+
+    // Length of the common prefix of a and b, up to 'limit' bytes.
+    std::size_t commonLength(const std::uint8_t* a, const std::uint8_t* b, std::size_t limit) {
+        std::size_t i = 0;
+        for (; i + sizeof(std::uint64_t) <= limit; i += sizeof(std::uint64_t)) {
+            std::uint64_t x, y;
+            std::memcpy(&x, a + i, sizeof x);
+            std::memcpy(&y, b + i, sizeof y);
+            if (x != y) {
+                break;
+            }
+        }
+        while (i < limit && a[i] == b[i]) {
+            ++i;
+        }
+        return i;
+    }
+
+    // How many bytes of 'current' from 'at' equal 'previous' from at + shift,
+    // looking at no more than 'limit' of them.
+    std::size_t matchLength(const std::vector<std::uint8_t>& previous, const std::vector<std::uint8_t>& current,
+        std::size_t at, std::ptrdiff_t shift, std::size_t limit) {
+        const std::ptrdiff_t source = static_cast<std::ptrdiff_t>(at) + shift;
+        if (source < 0 || static_cast<std::size_t>(source) >= previous.size()) {
+            return 0;
+        }
+        limit = std::min({ limit, current.size() - at, previous.size() - static_cast<std::size_t>(source) });
+        return commonLength(current.data() + at, previous.data() + source, limit);
+    }
+
+    // Looks for the bytes at 'at' near the current alignment in 'previous',
+    // taking the closest match.
+    bool findShift(const std::vector<std::uint8_t>& previous, const std::vector<std::uint8_t>& current,
+        std::size_t at, std::ptrdiff_t shift, std::ptrdiff_t& found) {
+        if (at + kAnchor > current.size() || previous.size() < kAnchor) {
+            return false;
+        }
+        std::uint64_t anchor[kAnchor / sizeof(std::uint64_t)];
+        std::memcpy(anchor, current.data() + at, kAnchor);
+        const std::ptrdiff_t aligned = static_cast<std::ptrdiff_t>(at) + shift;
+        const std::ptrdiff_t first = std::max<std::ptrdiff_t>(0, aligned - kResyncWindow);
+        const std::ptrdiff_t last = std::min<std::ptrdiff_t>(previous.size() - kAnchor, aligned + kResyncWindow);
+        std::ptrdiff_t best = kResyncWindow + 1;
+        for (std::ptrdiff_t source = first; source <= last; ++source) {
+            std::uint64_t word;
+            std::memcpy(&word, previous.data() + source, sizeof word);
+            const std::ptrdiff_t distance = source > aligned ? source - aligned : aligned - source;
+            if (word == anchor[0] && distance != 0 && distance < best &&
+                std::memcmp(previous.data() + source, anchor, kAnchor) == 0) {
+                best = distance;
+                found = source - static_cast<std::ptrdiff_t>(at);
+            }
+        }
+        return best <= kResyncWindow;
+    }
+
+    // Delta layout: varint size of the new frame, then runs of (zigzag change
+    // of alignment, varint bytes copied from the previous frame at that
+    // alignment, varint literal bytes, the literal bytes) up to its end.
+    // Copying at an alignment keeps the delta small on ticks where an entity
+    // spawns or despawns and everything after its column moves over.
+    // Returns false, with 'out' never having grown past 'limit', if the
+    // delta would, or once captureClock() passes 'deadline'; 'overBudget'
+    // then tells which.
+    bool encodeDelta(const std::vector<std::uint8_t>& previous, const std::vector<std::uint8_t>& current,
+        std::vector<std::uint8_t>& out, std::size_t limit, sf::Int64 deadline, bool& overBudget) {
+        overBudget = false;
+        out.clear();
+        Varint::put(out, current.size());
+        std::size_t at = 0;
+        std::ptrdiff_t shift = 0;
+        std::ptrdiff_t written = 0; // alignment the decoder is at
+        unsigned int resyncs = 0;
+        for (unsigned int runs = 0; at < current.size(); ++runs) {
+            if (runs % kRunsPerClockCheck == 0 && captureClock() > deadline) {
+                overBudget = true;
+                return false;
+            }
+            const std::size_t copy = matchLength(previous, current, at, shift, current.size());
+            at += copy;
+            const std::size_t literal = at;
+            std::ptrdiff_t nextShift = shift;
+            while (at < current.size() && matchLength(previous, current, at, shift, kMinMatch) < kMinMatch) {
+                if ((at - literal) % kResyncStride == kResyncStride - 1 && resyncs < kMaxResyncs) {
+                    ++resyncs;
+                    if (findShift(previous, current, at, shift, nextShift)) {
+                        break;
+                    }
+                }
+                ++at;
+            }
+            if (out.size() + kRunHeaderBytes + (at - literal) >= limit) {
+                return false;
+            }
+            Varint::putSigned(out, shift - written);
+            Varint::put(out, copy);
+            Varint::put(out, at - literal);
+            out.insert(out.end(), current.begin() + literal, current.begin() + at);
+            written = shift;
+            shift = nextShift;
+        }
+        return true;
+    }
+
+    bool applyDelta(const std::uint8_t* delta, std::size_t size, const std::vector<std::uint8_t>& previous,
+        std::vector<std::uint8_t>& frame) {
+        std::size_t offset = 0;
+        std::uint64_t frameSize;
+        if (!Varint::get(delta, size, offset, frameSize)) {
+            return false;
+        }
+        frame.resize(static_cast<std::size_t>(frameSize));
+        std::size_t at = 0;
+        std::int64_t shift = 0;
+        while (offset < size) {
+            std::int64_t shiftChange;
+            std::uint64_t copy, literal;
+            if (!Varint::getSigned(delta, size, offset, shiftChange) || !Varint::get(delta, size, offset, copy) ||
+                !Varint::get(delta, size, offset, literal)) {
+                return false;
+            }
+            shift += shiftChange;
+            const std::int64_t source = static_cast<std::int64_t>(at) + shift;
+            if (source < 0 || copy > previous.size() || static_cast<std::uint64_t>(source) > previous.size() - copy ||
+                literal > size - offset || copy + literal > frame.size() - at) {
+                return false;
+            }
+            std::memcpy(frame.data() + at, previous.data() + source, static_cast<std::size_t>(copy));
+            at += static_cast<std::size_t>(copy);
+            std::memcpy(frame.data() + at, delta + offset, static_cast<std::size_t>(literal));
+            offset += static_cast<std::size_t>(literal);
+            at += static_cast<std::size_t>(literal);
+        }
+        return at == frame.size();
+    }
+}
+
+RewindBuffer::RewindBuffer(const RewindConfig& config)
+    : mConfig(config),
+    mFrames(std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(config.seconds * config.tickRate)))),
+    mFrameLimit(config.byteBudget / kScratchShare) {
+    mPrevious.reserve(mFrameLimit);
+    mCurrent.reserve(mFrameLimit);
+    mDelta.reserve(mFrameLimit);
+    const std::size_t fixed = mFrames.size() * sizeof(Frame) + 3 * mFrameLimit;
+    mArena.resize(config.byteBudget > fixed ? config.byteBudget - fixed : 0);
+}
+
+void RewindBuffer::clear() {
+    mFirst = 0;
+    mFrameCount = 0;
+    mWrite = 0;
+    mBytesUsed = 0;
+    mSinceBase = 0;
+    mPrevious.clear();
+}
+
+std::uint64_t RewindBuffer::getOldestTick() const {
+    return empty() ? 0 : frameAt(0).tick;
+}
+
+std::uint64_t RewindBuffer::getNewestTick() const {
+    return empty() ? 0 : frameAt(mFrameCount - 1).tick;
+}
+
+std::size_t RewindBuffer::getMemoryFootprint() const {
+    return mArena.size() + mFrames.size() * sizeof(Frame) +
+        mPrevious.capacity() + mCurrent.capacity() + mDelta.capacity();
+}
+
+void RewindBuffer::capture(const Simulation& simulation) {
+    const std::uint64_t tick = simulation.getTickCount();
+    if (!empty() && tick <= getNewestTick()) {
+        return;
+    }
+    const sf::Int64 start = captureClock();
+    // Storing a base frame must still fit once the delta is given up
+    const sf::Int64 deadline = start + mConfig.captureBudgetMicros - mBaseStoreMicros;
+
+    mCurrent.clear();
+    simulation.saveState(mCurrent);
+    if (mCurrent.size() > mFrameLimit) {
+        // Bigger than the scratch: give the memory back and hold nothing
+        std::vector<std::uint8_t>().swap(mCurrent);
+        mCurrent.reserve(mFrameLimit);
+        clear();
+        return;
+    }
+    if (captureClock() > deadline) {
+        // No time left to store anything; the previous frame stays the newest
+        ++mSkipped;
+        mLastCaptureMicros = captureClock() - start;
+        mMaxCaptureMicros = std::max(mMaxCaptureMicros, mLastCaptureMicros);
+        return;
+    }
+
+    bool overBudget = false;
+    bool base = empty() || mSinceBase + 1 >= mConfig.baseInterval ||
+        !encodeDelta(mPrevious, mCurrent, mDelta, mCurrent.size(), deadline, overBudget);
+    mOverBudget += overBudget ? 1 : 0;
+    bool stored = !base && store(mDelta, tick, false);
+    if (!stored) {
+        // A base frame is due, or making room evicted the delta's base
+        base = true;
+        const sf::Int64 storeStart = captureClock();
+        stored = store(mCurrent, tick, true);
+        // Expect the next one to take as long, but never let one slow store
+        // leave deltas no time at all
+        mBaseStoreMicros = std::min(captureClock() - storeStart, mConfig.captureBudgetMicros / 2);
+    }
+
+    if (stored) {
+        if (base) {
+            mSinceBase = 0;
+            ++mBaseFrames;
+        }
+        else {
+            ++mSinceBase;
+            ++mDeltaFrames;
+        }
+        mPrevious.swap(mCurrent);
+    }
+    else {
+        // A single snapshot is larger than the whole frame ring
+        clear();
+    }
+
+    mLastCaptureMicros = captureClock() - start;
+    mMaxCaptureMicros = std::max(mMaxCaptureMicros, mLastCaptureMicros);
+}
+
+bool RewindBuffer::rewindTo(std::uint64_t tick, Simulation& simulation) {
+    if (empty() || tick < getOldestTick()) {
+        return false;
+    }
+    std::size_t target = mFrameCount - 1;
+    while (frameAt(target).tick > tick) {
+        --target;
+    }
+    std::size_t first = target;
+    while (!frameAt(first).base) {
+        --first;
+    }
+
+    const Frame& baseFrame = frameAt(first);
+    mCurrent.assign(mArena.begin() + baseFrame.offset, mArena.begin() + baseFrame.offset + baseFrame.size);
+    for (std::size_t i = first + 1; i <= target; ++i) {
+        const Frame& frame = frameAt(i);
+        if (!applyDelta(mArena.data() + frame.offset, frame.size, mCurrent, mPrevious)) {
+            mPrevious.clear();
+            return false;
+        }
+        mCurrent.swap(mPrevious);
+    }
+    if (!simulation.loadState(mCurrent.data(), mCurrent.size())) {
+        return false;
+    }
+
+    // The run continues from here, so what came after it is gone
+    for (std::size_t i = target + 1; i < mFrameCount; ++i) {
+        mBytesUsed -= frameAt(i).size;
+    }
+    mFrameCount = target + 1;
+    mWrite = frameAt(target).offset + frameAt(target).size;
+    mSinceBase = target - first;
+    mPrevious.swap(mCurrent);
+    return true;
+}
+
+bool RewindBuffer::store(const std::vector<std::uint8_t>& bytes, std::uint64_t tick, bool base) {
+    if (bytes.size() > mArena.size()) {
+        return false;
+    }
+    if (mFrameCount == mFrames.size()) {
+        dropOldestSegment();
+    }
+    std::size_t offset;
+    while (!place(bytes.size(), offset)) {
+        dropOldestSegment();
+    }
+    if (!base && empty()) {
+        return false;
+    }
+
+    std::memcpy(mArena.data() + offset, bytes.data(), bytes.size());
+    frameAt(mFrameCount++) = Frame{ tick, static_cast<std::uint32_t>(offset),
+        static_cast<std::uint32_t>(bytes.size()), base };
+    mWrite = offset + bytes.size();
+    mBytesUsed += bytes.size();
+    mCapturedBytes += bytes.size();
+    return true;
+}
+
+bool RewindBuffer::place(std::size_t size, std::size_t& offset) const {
+    if (empty()) {
+        offset = 0;
+        return true;
+    }
+    // Live bytes run from the oldest frame up to mWrite, wrapping at the end
+    const std::size_t oldest = frameAt(0).offset;
+    if (mWrite > oldest) {
+        if (mWrite + size <= mArena.size()) {
+            offset = mWrite;
+            return true;
+        }
+        if (size <= oldest) {
+            offset = 0;
+            return true;
+        }
+        return false;
+    }
+    if (mWrite + size <= oldest) {
+        offset = mWrite;
+        return true;
+    }
+    return false;
+}
+
+void RewindBuffer::dropOldestSegment() {
+    do {
+        mBytesUsed -= frameAt(0).size;
+        mFirst = (mFirst + 1) % mFrames.size();
+        --mFrameCount;
+    } while (!empty() && !frameAt(0).base);
+    if (empty()) {
+        mFirst = 0;
+        mWrite = 0;
+    }
+}
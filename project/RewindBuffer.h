@@ -0,0 +1,114 @@
+#pragma once
+#include <SFML/System/Time.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Simulation;
+
+struct RewindConfig {
+    float seconds = 30.0f; // history kept, at most
+    unsigned int tickRate = 60;
+    unsigned int baseInterval = 60; // ticks between full base frames
+    std::size_t byteBudget = 1024 * 1024; // all the buffer holds, allocated once
+    // Most one capture may cost, saving the snapshot included
+    sf::Int64 captureBudgetMicros = 500;
+};
+
+// "Rewind the last N seconds" for practice mode and collision debugging.
+// Every tick the Simulation snapshot (Simulation::saveState) is stored as
+// a delta against the previous tick's, with a full base frame every
+// baseInterval ticks. Most of a snapshot - the spawn RNG, the slot table,
+// the recorded inputs - does not change from one tick to the next, so a
+// delta is mostly runs copied from the previous frame. Runs are copied at an
+// offset that follows spawns and despawns, which move every column after
+// the one that grew or shrank.
+//
+// byteBudget holds everything: a fixed ring of seconds * tickRate frame
+// records, scratch for three snapshots of up to 1/16 of the budget each,
+// and a byte ring of frames taking the rest. When a ring is full the
+// oldest base frame and its deltas are dropped together, so memory never
+// grows after construction and the history is simply shorter when frames
+// are large. A run whose snapshot outgrows the scratch is not captured.
+//
+// A delta that would cost more than a base frame is stored as a base frame,
+// which also caps how many deltas a rewind has to replay. A capture costs
+// at most captureBudgetMicros: a delta still being encoded when only the
+// time to store a base frame is left becomes a base frame, and a tick
+// whose snapshot took even that time is skipped; rewindTo() then lands on
+// the tick before. Cost is the capturing thread's CPU time (wall time on
+// Windows, which only keeps that to the scheduler tick), so time the
+// scheduler hands to other threads mid-capture does not count.
+class RewindBuffer {
+public:
+    explicit RewindBuffer(const RewindConfig& config = RewindConfig());
+
+    void clear();
+
+    // Records 'simulation' as it is after its latest tick. Ticks must
+    // increase; call clear() when a new run starts.
+    void capture(const Simulation& simulation);
+
+    // Puts 'simulation' back to the newest captured tick at or before
+    // 'tick' and forgets everything captured after it. Returns false (and
+    // leaves the simulation alone) if no frame that old is held.
+    bool rewindTo(std::uint64_t tick, Simulation& simulation);
+
+    bool empty() const { return mFrameCount == 0; }
+    std::uint64_t getOldestTick() const;
+    std::uint64_t getNewestTick() const;
+    std::size_t getFrameCount() const { return mFrameCount; }
+    std::size_t getBytesUsed() const { return mBytesUsed; }
+    std::size_t getArenaSize() const { return mArena.size(); } // frame bytes the ring holds
+    std::size_t getByteBudget() const { return mConfig.byteBudget; }
+    // Everything the buffer holds on to: frame ring, records and scratch.
+    std::size_t getMemoryFootprint() const;
+
+    // Capture cost, for the debug overlay and --rewind-bench.
+    sf::Int64 getLastCaptureMicros() const { return mLastCaptureMicros; }
+    sf::Int64 getMaxCaptureMicros() const { return mMaxCaptureMicros; }
+    std::uint64_t getBaseFrameCount() const { return mBaseFrames; }
+    std::uint64_t getDeltaFrameCount() const { return mDeltaFrames; }
+    // Base frames stored because their delta would have run over
+    // captureBudgetMicros, and ticks skipped for lack of time.
+    std::uint64_t getOverBudgetCount() const { return mOverBudget; }
+    std::uint64_t getSkippedCount() const { return mSkipped; }
+    std::uint64_t getCapturedBytes() const { return mCapturedBytes; } // all frames ever stored
+
+private:
+    struct Frame {
+        std::uint64_t tick;
+        std::uint32_t offset; // into mArena
+        std::uint32_t size;
+        bool base;
+    };
+
+    Frame& frameAt(std::size_t i) { return mFrames[(mFirst + i) % mFrames.size()]; }
+    const Frame& frameAt(std::size_t i) const { return mFrames[(mFirst + i) % mFrames.size()]; }
+    bool store(const std::vector<std::uint8_t>& bytes, std::uint64_t tick, bool base);
+    bool place(std::size_t size, std::size_t& offset) const;
+    void dropOldestSegment();
+
+    RewindConfig mConfig;
+    std::vector<std::uint8_t> mArena;
+    std::vector<Frame> mFrames; // ring of mFrameCount records from mFirst
+    std::size_t mFirst = 0;
+    std::size_t mFrameCount = 0;
+    std::size_t mWrite = 0; // where the next frame goes in mArena
+    std::size_t mBytesUsed = 0;
+
+    std::vector<std::uint8_t> mPrevious; // last captured snapshot
+    std::vector<std::uint8_t> mCurrent;
+    std::vector<std::uint8_t> mDelta;
+    std::size_t mFrameLimit; // largest snapshot the scratch takes
+    std::uint64_t mSinceBase = 0;
+
+    sf::Int64 mLastCaptureMicros = 0;
+    sf::Int64 mMaxCaptureMicros = 0;
+    sf::Int64 mBaseStoreMicros = 0; // what the last base frame took to store
+    std::uint64_t mBaseFrames = 0;
+    std::uint64_t mDeltaFrames = 0;
+    std::uint64_t mOverBudget = 0;
+    std::uint64_t mSkipped = 0;
+    std::uint64_t mCapturedBytes = 0;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+// Picks the widest x86 vector extension the compiler is targeting. Kernels
+// test TRACK_SIMD_AVX / TRACK_SIMD_SSE and always keep a scalar loop for the
+// remainder (and for every other target).
+#if defined(__AVX__)
+#include <immintrin.h>
+#define TRACK_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TRACK_SIMD_SSE 1
+#endif
@@ -0,0 +1,140 @@
+#include "Simulation.h"
+#include <cstring>
+
+namespace {
+    const float SCORE_PER_SECOND = 10.0f;
+    const float MAGNET_DISTANCE = 300.0f;
+    const float MAGNET_PULL_SPEED = 5.0f;
+
+    // FNV-1a over the raw bytes of each value
+    class Checksum {
+    public:
+        template <typename T> void add(const T& value) {
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+            for (unsigned char byte : bytes) {
+                mHash = (mHash ^ byte) * 0x100000001B3ull;
+            }
+        }
+        std::uint64_t get() const { return mHash; }
+
+    private:
+        std::uint64_t mHash = 0xCBF29CE484222325ull;
+    };
+}
+
+Simulation::Simulation(const SimulationConfig& config)
+    : mTrack(config.capacity, config.seed, config.chunks), mScore(config.loadStoredScores), mSeed(config.seed),
+    mTickTime(sf::seconds(1.0f / static_cast<float>(config.tickRate > 0 ? config.tickRate : 60))),
+    mReplay(config.seed, config.tickRate > 0 ? config.tickRate : 60, config.chunks ? config.chunks->getHash() : 0) {
+    if (config.backgroundTrack) {
+        mTrack.startBackgroundGeneration(mTickTime);
+    }
+}
+
+void Simulation::perform(PlayerAction action) {
+    if (mIsOver) {
+        return;
+    }
+    switch (action) {
+    case PlayerAction::MOVE_LEFT: mPlayer.moveLeft(); break;
+    case PlayerAction::MOVE_RIGHT: mPlayer.moveRight(); break;
+    case PlayerAction::JUMP: mPlayer.jump(); break;
+    case PlayerAction::SLIDE: mPlayer.slide(); break;
+    }
+    if (mRecording) {
+        mReplay.record(mTickCount, action);
+    }
+}
+
+void Simulation::cloneFrom(const Simulation& other) {
+    mPlayer = other.mPlayer;
+    mTrack = other.mTrack;
+    mScore = other.mScore;
+    mSeed = other.mSeed;
+    mTickTime = other.mTickTime;
+    mLastCollision = other.mLastCollision;
+    mTickCount = other.mTickCount;
+    mElapsedSeconds = other.mElapsedSeconds;
+    mIsOver = other.mIsOver;
+    mRecording = false;
+}
+
+std::uint64_t Simulation::getChecksum() const {
+    Checksum sum;
+    sum.add(mTickCount);
+    sum.add(mScore.getScore());
+    sum.add(mScore.getCoins());
+    sum.add(mPlayer.getPosition().x);
+    sum.add(mPlayer.getPosition().y);
+    const EntityWorld& world = mTrack.getWorld();
+    const auto& obstacles = world.getObstacles();
+    for (size_t i = 0; i < obstacles.size(); ++i) {
+        sum.add(obstacles.get<Position>(i).x);
+        sum.add(obstacles.get<Position>(i).y);
+    }
+    const CoinStore& coins = world.getCoins();
+    for (size_t i = 0; i < coins.size(); ++i) {
+        sum.add(coins.getPosition(i).x);
+        sum.add(coins.getPosition(i).y);
+    }
+    return sum.get();
+}
+
+void Simulation::saveState(std::vector<std::uint8_t>& out) const {
+    SnapshotWriter writer(out);
+    writer.value(mSeed);
+    writer.value(mTickTime);
+    writer.value(mTickCount);
+    writer.value(mElapsedSeconds);
+    writer.value(mIsOver);
+    writer.value(mLastCollision);
+    mPlayer.saveState(writer);
+    mTrack.saveState(writer);
+    mScore.saveState(writer);
+    mReplay.saveState(writer);
+}
+
+bool Simulation::loadState(const std::uint8_t* data, std::size_t size) {
+    SnapshotReader reader(data, size);
+    return reader.value(mSeed) && reader.value(mTickTime) && reader.value(mTickCount) &&
+        reader.value(mElapsedSeconds) && reader.value(mIsOver) && reader.value(mLastCollision) &&
+        mPlayer.loadState(reader) && mTrack.loadState(reader) && mScore.loadState(reader) &&
+        mReplay.loadState(reader) && reader.atEnd() && mTickTime > sf::Time::Zero &&
+        mReplay.getChunkHash() == (mTrack.getChunks() ? mTrack.getChunks()->getHash() : 0);
+}
+
+void Simulation::step() {
+    if (mIsOver) {
+        return;
+    }
+    const sf::Time dt = mTickTime;
+    const float dtSeconds = dt.asSeconds();
+    mTickCount++;
+    mElapsedSeconds += dtSeconds;
+    mReplay.finish(mTickCount);
+
+    mPlayer.update(dt);
+    mTrack.update(dt);
+    mScore.addScore(SCORE_PER_SECOND * dtSeconds);
+    if (mPlayer.takeEffectChanges()) {
+        mScore.setMultiplier(mPlayer.getCoinMultiplier());
+    }
+
+    mLastCollision = collideSystem(mTrack.getWorld(), mPlayer);
+    if (mLastCollision.fatal) {
+        mIsOver = true;
+        return;
+    }
+    if (mLastCollision.coins > 0) {
+        mScore.addCoins(mLastCollision.coins);
+    }
+
+    // Only coins within the magnet range are pulled towards the player center
+    if (mPlayer.isMagnetActive()) {
+        sf::FloatRect playerBounds = mPlayer.getBounds();
+        sf::Vector2f playerPos(playerBounds.left + playerBounds.width / 2.0f,
+            playerBounds.top + playerBounds.height / 2.0f);
+        mTrack.getWorld().getCoins().attract(playerPos, MAGNET_DISTANCE, MAGNET_PULL_SPEED * dtSeconds);
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "EntitySystems.h"
+#include "Player.h"
+#include "Replay.h"
+#include "ScoreManager.h"
+#include "TrackManager.h"
+#include <SFML/System/Time.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+struct SimulationConfig {
+    TrackCapacityConfig capacity;
+    unsigned int seed = std::random_device{}();
+    unsigned int tickRate = 60;
+    bool loadStoredScores = true; // read the saved high score at start
+    const ChunkLibrary* chunks = nullptr; // authored track chunks; must outlive the run
+    bool backgroundTrack = false; // decide spawns ahead on a worker thread (same run either way)
+};
+
+// One run of the game with no window attached: the player, the track,
+// collisions and scoring, advanced one fixed tick at a time. GameEngine
+// drives one and draws it through WorldRenderer; headless runs drive it
+// directly as fast as the CPU allows.
+//
+// Given the same seed and tick rate, the same actions performed before the
+// same ticks give a bit-identical run; every action is recorded into a
+// Replay so a run can be played back later.
+class Simulation {
+public:
+    explicit Simulation(const SimulationConfig& config = SimulationConfig());
+
+    // Advances the run by one tick of 1 / tickRate seconds. Does nothing
+    // once the run is over.
+    void step();
+
+    // Applies a player action before the next tick and records it.
+    void perform(PlayerAction action);
+
+    bool isOver() const { return mIsOver; }
+    // Result of the last tick's collision pass (the fatal one once over).
+    const CollisionReport& getLastCollision() const { return mLastCollision; }
+    std::uint64_t getTickCount() const { return mTickCount; }
+    float getElapsedSeconds() const { return mElapsedSeconds; }
+    unsigned int getSeed() const { return mSeed; }
+    sf::Time getTickTime() const { return mTickTime; }
+    const Replay& getReplay() const { return mReplay; }
+
+    // Hash of the observable state (tick, score, player and entity
+    // positions). Equal checksums after a replay mean the run reproduced.
+    std::uint64_t getChecksum() const;
+
+    // Appends the whole run - player, track, entities, spawn RNG, score and
+    // the replay so far - to 'out'. Restoring it into any Simulation
+    // continues the run exactly where it was saved, given the same chunk
+    // library.
+    void saveState(std::vector<std::uint8_t>& out) const;
+    // Returns false if 'data' is not a complete snapshot, or was taken with
+    // another chunk library; the simulation is then in an unspecified state
+    // and should be discarded.
+    bool loadState(const std::uint8_t* data, std::size_t size);
+
+    // Copies the run as it stands in 'other', except its replay, into this
+    // simulation's storage: with the same capacity config nothing is
+    // allocated, so lookahead searches can clone the run every tick. Actions
+    // performed on the copy are not recorded.
+    void cloneFrom(const Simulation& other);
+
+    Player& getPlayer() { return mPlayer; }
+    const Player& getPlayer() const { return mPlayer; }
+    TrackManager& getTrack() { return mTrack; }
+    const TrackManager& getTrack() const { return mTrack; }
+    ScoreManager& getScore() { return mScore; }
+    const ScoreManager& getScore() const { return mScore; }
+
+private:
+    Player mPlayer;
+    TrackManager mTrack;
+    ScoreManager mScore;
+
+    unsigned int mSeed;
+    sf::Time mTickTime;
+    Replay mReplay;
+    CollisionReport mLastCollision;
+    std::uint64_t mTickCount = 0;
+    float mElapsedSeconds = 0.0f;
+    bool mIsOver = false;
+    bool mRecording = true; // false for lookahead copies
+};
@@ -0,0 +1,59 @@
+#include "Snapshot.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    const char kMagic[4] = { 'M', 'S', 'N', 'P' };
+
+    std::uint64_t hashBytes(const std::uint8_t* data, std::size_t size) {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ data[i]) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t size;
+        std::uint64_t hash;
+    };
+}
+
+bool Snapshot::save(const std::filesystem::path& path, const std::vector<std::uint8_t>& payload) {
+    Header header;
+    std::copy(std::begin(kMagic), std::end(kMagic), header.magic);
+    header.version = VERSION;
+    header.size = payload.size();
+    header.hash = hashBytes(payload.data(), payload.size());
+
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    std::filesystem::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        if (!file) {
+            return false;
+        }
+    }
+    std::filesystem::rename(temp, path, ec);
+    return !ec;
+}
+
+bool Snapshot::load(const std::filesystem::path& path, std::vector<std::uint8_t>& payload) {
+    std::ifstream file(path, std::ios::binary);
+    Header header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        !std::equal(std::begin(kMagic), std::end(kMagic), header.magic) || header.version != VERSION) {
+        return false;
+    }
+    payload.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return payload.size() == header.size && hashBytes(payload.data(), payload.size()) == header.hash;
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Appends game state to a byte buffer for a snapshot. Plain-data values and
+// whole vectors of them are copied as raw bytes, so a snapshot is mostly a
+// handful of memcpys; the price is that it only restores into the same
+// build on the same platform, which is all crash recovery needs.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::vector<std::uint8_t>& out) : mOut(out) {}
+
+    template <typename T> void value(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be plain data");
+        append(&value, sizeof(T));
+    }
+
+    template <typename T> void values(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be plain data");
+        value<std::uint64_t>(values.size());
+        append(values.data(), values.size() * sizeof(T));
+    }
+
+    // The 'count' values of a ring from slot 'head' on, wrapping at its end,
+    // stored in order the way values() stores a vector.
+    template <typename T> void values(const std::vector<T>& ring, std::size_t head, std::size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be plain data");
+        const std::size_t first = count < ring.size() - head ? count : ring.size() - head;
+        value<std::uint64_t>(count);
+        append(ring.data() + head, first * sizeof(T));
+        append(ring.data(), (count - first) * sizeof(T));
+    }
+
+    void text(const std::string& text) {
+        value<std::uint64_t>(text.size());
+        append(text.data(), text.size());
+    }
+
+private:
+    void append(const void* data, std::size_t size) {
+        const std::size_t offset = mOut.size();
+        mOut.resize(offset + size);
+        if (size > 0) {
+            std::memcpy(mOut.data() + offset, data, size);
+        }
+    }
+
+    std::vector<std::uint8_t>& mOut;
+};
+
+// Reads back what SnapshotWriter wrote, in the same order. Every read fails
+// (and keeps failing) once the data runs out, so callers can chain reads
+// and check once.
+class SnapshotReader {
+public:
+    SnapshotReader(const std::uint8_t* data, std::size_t size) : mData(data), mSize(size) {}
+
+    template <typename T> bool value(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be plain data");
+        return take(&value, sizeof(T));
+    }
+
+    // Resizes 'values' to the stored length; vectors reserved up front keep
+    // their capacity.
+    template <typename T> bool values(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be plain data");
+        std::uint64_t count = 0;
+        if (!value(count) || count > (mSize - mOffset) / (sizeof(T) > 0 ? sizeof(T) : 1)) {
+            return fail();
+        }
+        values.resize(static_cast<std::size_t>(count));
+        return take(values.data(), values.size() * sizeof(T));
+    }
+
+    bool text(std::string& text) {
+        std::uint64_t length = 0;
+        if (!value(length) || length > mSize - mOffset) {
+            return fail();
+        }
+        text.assign(reinterpret_cast<const char*>(mData) + mOffset, static_cast<std::size_t>(length));
+        mOffset += static_cast<std::size_t>(length);
+        return true;
+    }
+
+    bool ok() const { return mOk; }
+    bool atEnd() const { return mOffset == mSize; }
+
+private:
+    bool take(void* out, std::size_t size) {
+        if (!mOk || size > mSize - mOffset) {
+            return fail();
+        }
+        if (size > 0) {
+            std::memcpy(out, mData + mOffset, size);
+        }
+        mOffset += size;
+        return true;
+    }
+
+    bool fail() {
+        mOk = false;
+        return false;
+    }
+
+    const std::uint8_t* mData;
+    std::size_t mSize;
+    std::size_t mOffset = 0;
+    bool mOk = true;
+};
+
+// Snapshot files: "MSNP", u32 format version, u64 payload size, u64 FNV-1a
+// hash of the payload, then the payload. Bump VERSION whenever any
+// saveState() changes what it writes.
+namespace Snapshot {
+    constexpr std::uint32_t VERSION = 8;
+
+    // Writes next to 'path' and renames over it, so a crash mid-write
+    // leaves the previous snapshot intact.
+    bool save(const std::filesystem::path& path, const std::vector<std::uint8_t>& payload);
+
+    // Returns false for a missing, foreign, old-version or damaged file.
+    bool load(const std::filesystem::path& path, std::vector<std::uint8_t>& payload);
+}
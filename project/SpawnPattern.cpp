@@ -0,0 +1,225 @@
+#include "SpawnPattern.h"
+#include "LaneSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+namespace {
+    const float SPAWN_Y = -200.0f;
+
+    // Each frame starts with a header naming the context whose pool it came
+    // from (null for heap frames), padded to keep the frame aligned
+    struct alignas(std::max_align_t) FrameHeader {
+        PatternContext* context;
+    };
+
+    const std::size_t BLOCK_WORDS = PatternContext::FRAME_BLOCK_SIZE / sizeof(std::max_align_t);
+}
+
+SpawnPattern& SpawnPattern::operator=(SpawnPattern&& other) noexcept {
+    if (this != &other) {
+        reset();
+        mHandle = other.mHandle;
+        other.mHandle = nullptr;
+    }
+    return *this;
+}
+
+void SpawnPattern::reset() {
+    if (mHandle) {
+        mHandle.destroy();
+        mHandle = nullptr;
+    }
+}
+
+void* SpawnPattern::promise_type::operator new(std::size_t size, PatternContext& context, const PatternArgs&) {
+    return context.allocateFrame(size);
+}
+
+void SpawnPattern::promise_type::operator delete(void* frame, std::size_t) {
+    FrameHeader* header = static_cast<FrameHeader*>(frame) - 1;
+    if (header->context) {
+        header->context->freeFrame(header);
+    }
+    else {
+        ::operator delete(header);
+    }
+}
+
+PatternContext::PatternContext(SpawnList& spawns, std::size_t frames)
+    : mSpawns(spawns), mPool(frames * BLOCK_WORDS) {
+    mFreeBlocks.reserve(frames);
+    for (std::size_t block = frames; block-- > 0;) {
+        mFreeBlocks.push_back(static_cast<std::uint32_t>(block));
+    }
+}
+
+void PatternContext::spawnObstacle(ObstacleType type, int lane, float ahead) {
+    if (!mReplaying) {
+        mSpawns.spawnObstacle(type, LaneSystem::getLaneCenter(lane), SPAWN_Y - ahead);
+    }
+}
+
+void PatternContext::spawnCoin(int lane, float ahead) {
+    if (!mReplaying) {
+        mSpawns.spawnCoin(LaneSystem::getLaneCenter(lane), SPAWN_Y - ahead);
+    }
+}
+
+void* PatternContext::allocateFrame(std::size_t size) {
+    FrameHeader* header;
+    if (sizeof(FrameHeader) + size <= FRAME_BLOCK_SIZE && !mFreeBlocks.empty()) {
+        header = reinterpret_cast<FrameHeader*>(mPool.data() + mFreeBlocks.back() * BLOCK_WORDS);
+        mFreeBlocks.pop_back();
+        header->context = this;
+    }
+    else {
+        header = static_cast<FrameHeader*>(::operator new(sizeof(FrameHeader) + size));
+        header->context = nullptr;
+        mHeapFrames++;
+    }
+    return header + 1;
+}
+
+void PatternContext::freeFrame(void* block) {
+    const std::size_t offset = static_cast<std::max_align_t*>(block) - mPool.data();
+    mFreeBlocks.push_back(static_cast<std::uint32_t>(offset / BLOCK_WORDS));
+}
+
+PatternRunner::PatternRunner(SpawnList& spawns, std::size_t capacity)
+    : mContext(spawns, capacity), mSlots(capacity), mFrames(capacity), mTimers(capacity) {
+    mDistanceWaits.reserve(capacity);
+}
+
+PatternRunner& PatternRunner::operator=(const PatternRunner& other) {
+    if (this == &other) {
+        return *this;
+    }
+    for (SpawnPattern& frame : mFrames) {
+        frame.reset();
+    }
+    mSlots = other.mSlots;
+    mFrames.resize(mSlots.size());
+    mTimers = other.mTimers;
+    mDistanceWaits = other.mDistanceWaits;
+    mDistanceSequence = other.mDistanceSequence;
+    mTravelled = other.mTravelled;
+    mTickSeconds = other.mTickSeconds;
+    mActive = other.mActive;
+    rebuildFrames();
+    return *this;
+}
+
+bool PatternRunner::launch(PatternType type, const PatternArgs& args) {
+    for (std::uint32_t slot = 0; slot < mSlots.size(); ++slot) {
+        if (mSlots[slot].active) {
+            continue;
+        }
+        mSlots[slot] = Slot{ type, true, 0, args };
+        mFrames[slot] = getPattern(type)(mContext, args);
+        mActive++;
+        resume(slot);
+        return true;
+    }
+    return false;
+}
+
+void PatternRunner::update(float dt, float distance) {
+    mTickSeconds = dt;
+    mTravelled += distance;
+    mTimers.advance([this](std::uint16_t slot) { resume(slot); });
+    while (!mDistanceWaits.empty() && mDistanceWaits.front().distance <= mTravelled) {
+        const std::uint32_t slot = mDistanceWaits.front().slot;
+        std::pop_heap(mDistanceWaits.begin(), mDistanceWaits.end(), &PatternRunner::wakesLater);
+        mDistanceWaits.pop_back();
+        resume(slot);
+    }
+}
+
+bool PatternRunner::wakesLater(const DistanceWait& a, const DistanceWait& b) {
+    return a.distance != b.distance ? a.distance > b.distance : a.sequence > b.sequence;
+}
+
+void PatternRunner::resume(std::uint32_t slot) {
+    SpawnPattern& frame = mFrames[slot];
+    frame.resume();
+    mSlots[slot].resumes++;
+    if (frame.isDone()) {
+        frame.reset();
+        mSlots[slot].active = false;
+        mActive--;
+    }
+    else {
+        park(slot);
+    }
+}
+
+void PatternRunner::park(std::uint32_t slot) {
+    const SpawnPattern::promise_type& promise = mFrames[slot].getPromise();
+    if (promise.wait == SpawnPattern::promise_type::Wait::DISTANCE) {
+        mDistanceWaits.push_back(DistanceWait{ mTravelled + promise.amount, mDistanceSequence++, slot });
+        std::push_heap(mDistanceWaits.begin(), mDistanceWaits.end(), &PatternRunner::wakesLater);
+        return;
+    }
+    std::uint64_t ticks = 1;
+    if (promise.wait == SpawnPattern::promise_type::Wait::SECONDS && mTickSeconds > 0.0f) {
+        ticks = static_cast<std::uint64_t>(std::max(1.0f, std::round(promise.amount / mTickSeconds)));
+    }
+    mTimers.schedule(ticks, static_cast<std::uint16_t>(slot));
+}
+
+void PatternRunner::rebuildFrames() {
+    // Wake-ups are already in the wheel and the heap; this only brings each
+    // frame back to the pause it was at
+    mContext.mReplaying = true;
+    for (std::uint32_t slot = 0; slot < mSlots.size(); ++slot) {
+        if (!mSlots[slot].active) {
+            continue;
+        }
+        mFrames[slot] = getPattern(mSlots[slot].type)(mContext, mSlots[slot].args);
+        for (std::uint32_t i = 0; i < mSlots[slot].resumes && !mFrames[slot].isDone(); ++i) {
+            mFrames[slot].resume();
+        }
+    }
+    mContext.mReplaying = false;
+}
+
+void PatternRunner::saveState(SnapshotWriter& writer) const {
+    writer.values(mSlots);
+    mTimers.saveState(writer);
+    writer.values(mDistanceWaits);
+    writer.value(mDistanceSequence);
+    writer.value(mTravelled);
+    writer.value(mTickSeconds);
+}
+
+bool PatternRunner::loadState(SnapshotReader& reader) {
+    const std::size_t capacity = mSlots.size();
+    for (SpawnPattern& frame : mFrames) {
+        frame.reset();
+    }
+    if (!reader.values(mSlots) || mSlots.size() != capacity || !mTimers.loadState(reader) ||
+        !reader.values(mDistanceWaits) || !reader.value(mDistanceSequence) || !reader.value(mTravelled) ||
+        !reader.value(mTickSeconds)) {
+        mSlots.assign(capacity, Slot());
+        mActive = 0;
+        return false;
+    }
+    mActive = 0;
+    bool valid = true;
+    for (const Slot& slot : mSlots) {
+        mActive += slot.active ? 1 : 0;
+        valid = valid && (!slot.active || slot.type < PatternType::COUNT);
+    }
+    for (const DistanceWait& wait : mDistanceWaits) {
+        valid = valid && wait.slot < capacity;
+    }
+    if (!valid) {
+        mSlots.assign(capacity, Slot());
+        mDistanceWaits.clear();
+        mActive = 0;
+        return false;
+    }
+    rebuildFrames();
+    return true;
+}
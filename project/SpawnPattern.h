@@ -0,0 +1,191 @@
+#pragma once
+#include "ConcreteObstacles.h"
+#include "Snapshot.h"
+#include "SpawnRecord.h"
+#include "TimingWheel.h"
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+class PatternContext;
+
+// Launch parameters of one pattern run.
+struct PatternArgs {
+    int lane = 0;           // lane the pattern starts in
+    std::uint32_t seed = 0; // for the pattern's own random choices
+};
+
+// Return type of a spawn-pattern coroutine, e.g.
+//     SpawnPattern coneSlalom(PatternContext& track, PatternArgs args) {
+//         track.spawnObstacle(ObstacleType::CONE, args.lane);
+//         co_await track.wait(0.5f);
+//         ...
+//     }
+// Owns the coroutine frame. Patterns start suspended; PatternRunner runs
+// them to each pause and resumes them when it is over.
+class SpawnPattern {
+public:
+    struct promise_type {
+        // The pause the pattern is suspended at
+        enum class Wait : std::uint8_t { NONE, SECONDS, DISTANCE };
+        Wait wait = Wait::NONE;
+        float amount = 0.0f;
+
+        SpawnPattern get_return_object() {
+            return SpawnPattern(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        // Frames come from the context's pool, found through the pattern's
+        // parameters. There is deliberately no plain operator new, so a
+        // pattern with any other signature does not compile.
+        static void* operator new(std::size_t size, PatternContext& context, const PatternArgs& args);
+        static void operator delete(void* frame, std::size_t size);
+    };
+
+    SpawnPattern() = default;
+    SpawnPattern(SpawnPattern&& other) noexcept : mHandle(other.mHandle) { other.mHandle = nullptr; }
+    SpawnPattern& operator=(SpawnPattern&& other) noexcept;
+    SpawnPattern(const SpawnPattern&) = delete;
+    SpawnPattern& operator=(const SpawnPattern&) = delete;
+    ~SpawnPattern() { reset(); }
+
+    bool isValid() const { return static_cast<bool>(mHandle); }
+    bool isDone() const { return mHandle.done(); }
+    // Runs the pattern to its next pause or its end.
+    void resume() { mHandle.resume(); }
+    const promise_type& getPromise() const { return mHandle.promise(); }
+    // Destroys the frame.
+    void reset();
+
+private:
+    explicit SpawnPattern(std::coroutine_handle<promise_type> handle) : mHandle(handle) {}
+
+    std::coroutine_handle<promise_type> mHandle;
+};
+
+// What a pattern co_awaits. Returned by PatternContext::wait() and travel().
+struct PatternPause {
+    SpawnPattern::promise_type::Wait wait;
+    float amount;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<SpawnPattern::promise_type> pattern) const noexcept {
+        pattern.promise().wait = wait;
+        pattern.promise().amount = amount;
+    }
+    void await_resume() const noexcept {}
+};
+
+// The track as a pattern sees it, and the memory its frame lives in.
+//
+// A pattern's body may depend only on its PatternArgs (seed its own RNG
+// from args.seed): copies and snapshots keep just the arguments and how
+// many times the pattern has resumed, and rebuild the frame by running it
+// that far again with spawning switched off.
+class PatternContext {
+public:
+    // Frame pool block size. Bigger frames still work but take the heap.
+    static constexpr std::size_t FRAME_BLOCK_SIZE = 256;
+
+    PatternContext(SpawnList& spawns, std::size_t frames);
+    PatternContext(const PatternContext&) = delete;
+    PatternContext& operator=(const PatternContext&) = delete;
+
+    // Spawns on the usual spawn line in 'lane', 'ahead' pixels further up.
+    void spawnObstacle(ObstacleType type, int lane, float ahead = 0.0f);
+    void spawnCoin(int lane, float ahead = 0.0f);
+
+    // Resumes the pattern after 'seconds' of game time.
+    PatternPause wait(float seconds) const { return PatternPause{ SpawnPattern::promise_type::Wait::SECONDS, seconds }; }
+    // Resumes the pattern once the track has scrolled 'pixels' further.
+    PatternPause travel(float pixels) const { return PatternPause{ SpawnPattern::promise_type::Wait::DISTANCE, pixels }; }
+
+    // Frames that did not fit a pool block, or found the pool full.
+    std::size_t getHeapFrameCount() const { return mHeapFrames; }
+
+private:
+    friend class PatternRunner;
+    friend struct SpawnPattern::promise_type;
+
+    void* allocateFrame(std::size_t size);
+    void freeFrame(void* block);
+
+    SpawnList& mSpawns;
+    bool mReplaying = false;
+    std::vector<std::max_align_t> mPool;
+    std::vector<std::uint32_t> mFreeBlocks;
+    std::size_t mHeapFrames = 0;
+};
+
+// Registered patterns. New ones are added here and in SpawnPatterns.cpp.
+enum class PatternType : std::uint8_t { CONE_SLALOM, BARRIER_GAUNTLET, COUNT };
+
+using PatternFunction = SpawnPattern (*)(PatternContext& track, PatternArgs args);
+PatternFunction getPattern(PatternType type);
+
+// Runs a TrackManager's spawn patterns. A pattern waiting on time sits in
+// a timing wheel and one waiting on distance in a heap ordered by where it
+// wakes, so suspended patterns cost nothing per tick: update() only looks
+// at the next due timer and the nearest distance.
+//
+// Copies and snapshots rebuild each running pattern's frame (see
+// PatternContext), so TrackManager stays copyable for the autopilot and
+// snapshottable for rewind and crash recovery.
+class PatternRunner {
+public:
+    PatternRunner(SpawnList& spawns, std::size_t capacity);
+    PatternRunner(const PatternRunner&) = delete;
+    // Takes on 'other's patterns, rebuilt in this runner's pool and spawning
+    // into this runner's list.
+    PatternRunner& operator=(const PatternRunner& other);
+
+    // Starts a pattern and runs it to its first pause. Returns false if
+    // every slot is busy.
+    bool launch(PatternType type, const PatternArgs& args);
+
+    // One tick of 'dt' seconds over which the track scrolled 'distance'
+    // pixels: resumes every pattern whose pause is over.
+    void update(float dt, float distance);
+
+    std::size_t getActiveCount() const { return mActive; }
+    std::size_t getCapacity() const { return mSlots.size(); }
+    const PatternContext& getContext() const { return mContext; }
+
+    void saveState(SnapshotWriter& writer) const;
+    bool loadState(SnapshotReader& reader);
+
+private:
+    struct Slot {
+        PatternType type = PatternType::CONE_SLALOM;
+        bool active = false;
+        std::uint32_t resumes = 0;
+        PatternArgs args;
+    };
+
+    struct DistanceWait {
+        double distance;
+        std::uint64_t sequence; // ties wake in the order they were parked
+        std::uint32_t slot;
+    };
+
+    static bool wakesLater(const DistanceWait& a, const DistanceWait& b);
+    void resume(std::uint32_t slot);
+    void park(std::uint32_t slot);
+    void rebuildFrames();
+
+    PatternContext mContext;
+    std::vector<Slot> mSlots;
+    std::vector<SpawnPattern> mFrames;
+    TimingWheel mTimers; // event = slot
+    std::vector<DistanceWait> mDistanceWaits; // min-heap on distance
+    std::uint64_t mDistanceSequence = 0;
+    double mTravelled = 0.0;
+    float mTickSeconds = 0.0f;
+    std::size_t mActive = 0;
+};
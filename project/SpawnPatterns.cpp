@@ -0,0 +1,54 @@
+#include "SpawnPattern.h"
+#include "LaneSystem.h"
+#include <algorithm>
+#include <random>
+
+namespace {
+    // Cones weaving from one side of the track to the other and back over
+    // about three seconds. Now and then a cone repeats its lane; a coin
+    // trails each one so stepping round it pays.
+    SpawnPattern coneSlalom(PatternContext& track, PatternArgs args) {
+        std::minstd_rand rng(args.seed);
+        int lane = args.lane;
+        int step = lane == LaneSystem::LANE_COUNT - 1 ? -1 : 1;
+        for (int cone = 0; cone < 7; ++cone) {
+            track.spawnObstacle(ObstacleType::CONE, lane);
+            track.spawnCoin(lane, 120.0f);
+            co_await track.wait(0.45f);
+            if (rng() % 4 == 0) {
+                continue;
+            }
+            if (lane + step < 0 || lane + step >= LaneSystem::LANE_COUNT) {
+                step = -step;
+            }
+            lane += step;
+        }
+    }
+
+    // Rows of barriers a fixed distance apart, with coins marking the one
+    // open lane. The gap moves at most one lane per row, so it can always
+    // be reached at any speed.
+    SpawnPattern barrierGauntlet(PatternContext& track, PatternArgs args) {
+        std::minstd_rand rng(args.seed);
+        int gap = args.lane;
+        for (int row = 0; row < 5; ++row) {
+            for (int lane = 0; lane < LaneSystem::LANE_COUNT; ++lane) {
+                if (lane == gap) {
+                    track.spawnCoin(lane);
+                }
+                else {
+                    track.spawnObstacle(ObstacleType::BARRIER, lane);
+                }
+            }
+            co_await track.travel(360.0f);
+            gap = std::clamp(gap + static_cast<int>(rng() % 3) - 1, 0, LaneSystem::LANE_COUNT - 1);
+        }
+    }
+
+    // In PatternType order
+    const PatternFunction PATTERNS[] = { &coneSlalom, &barrierGauntlet };
+    static_assert(sizeof(PATTERNS) / sizeof(PATTERNS[0]) == static_cast<std::size_t>(PatternType::COUNT),
+        "every PatternType needs a pattern");
+}
+
+PatternFunction getPattern(PatternType type) { return PATTERNS[static_cast<std::size_t>(type)]; }
@@ -0,0 +1,52 @@
+#pragma once
+#include "Obstacle.h"
+#include "PowerUp.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One decision of track generation, applied to the world on its tick.
+struct SpawnRecord {
+    enum class Kind : std::uint8_t { OBSTACLE, POWER_UP, COIN, GAME_SPEED };
+
+    std::uint64_t tick;
+    Kind kind;
+    std::uint8_t type; // ObstacleType or PowerUpType
+    float x;           // the new speed for GAME_SPEED
+    float y;
+};
+
+// Where track generation writes its decisions. The spawn calls mirror
+// EntityWorld's, so patterns and chunks can write to either.
+class SpawnList {
+public:
+    // Room reserved up front: more than one tick ever decides with the
+    // built-in layouts, so lists cleared every tick, and copies of them,
+    // never reallocate. A bigger authored chunk grows the list once.
+    static constexpr std::size_t TICK_CAPACITY = 256;
+
+    SpawnList() { mRecords.reserve(TICK_CAPACITY); }
+    // Tick the following records take effect on.
+    void setTick(std::uint64_t tick) { mTick = tick; }
+
+    void spawnObstacle(ObstacleType type, float x, float y) {
+        push(SpawnRecord::Kind::OBSTACLE, static_cast<std::uint8_t>(type), x, y);
+    }
+    void spawnPowerUp(PowerUpType type, float x, float y) {
+        push(SpawnRecord::Kind::POWER_UP, static_cast<std::uint8_t>(type), x, y);
+    }
+    void spawnCoin(float x, float y) { push(SpawnRecord::Kind::COIN, 0, x, y); }
+    void setGameSpeed(float speed) { push(SpawnRecord::Kind::GAME_SPEED, 0, speed, 0.0f); }
+
+    std::vector<SpawnRecord>& getRecords() { return mRecords; }
+    const std::vector<SpawnRecord>& getRecords() const { return mRecords; }
+    void clear() { mRecords.clear(); }
+
+private:
+    void push(SpawnRecord::Kind kind, std::uint8_t type, float x, float y) {
+        mRecords.push_back(SpawnRecord{ mTick, kind, type, x, y });
+    }
+
+    std::uint64_t mTick = 0;
+    std::vector<SpawnRecord> mRecords;
+};
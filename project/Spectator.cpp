@@ -0,0 +1,149 @@
+#include "Spectator.h"
+#include "Simulation.h"
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <algorithm>
+
+bool SpectatorServer::listen(unsigned short port, const sf::IpAddress& address) {
+    mListener.setBlocking(false);
+    mListening = mListener.listen(port, address) == sf::Socket::Done;
+    return mListening;
+}
+
+void SpectatorServer::acceptClients() {
+    while (mClients.size() < MAX_CLIENTS) {
+        auto socket = std::make_unique<sf::TcpSocket>();
+        if (mListener.accept(*socket) != sf::Socket::Done) {
+            return;
+        }
+        socket->setBlocking(false);
+        Client client;
+        client.socket = std::move(socket);
+        client.pending.reserve(4096);
+        mClients.push_back(std::move(client));
+    }
+}
+
+void SpectatorServer::flush(Client& client) {
+    if (client.sentOffset < client.pending.size()) {
+        std::size_t sent = 0;
+        const sf::Socket::Status status = client.socket->send(client.pending.data() + client.sentOffset,
+            client.pending.size() - client.sentOffset, sent);
+        if (status == sf::Socket::Disconnected || status == sf::Socket::Error) {
+            client.dropped = true;
+            return;
+        }
+        client.sentOffset += sent;
+    }
+    if (client.sentOffset == client.pending.size()) {
+        client.pending.clear();
+        client.sentOffset = 0;
+    }
+    else if (client.pending.size() - client.sentOffset > MAX_BACKLOG) {
+        client.dropped = true; // too slow to keep up
+    }
+}
+
+void SpectatorServer::publish(const Simulation& simulation) {
+    if (!mListening) {
+        return;
+    }
+    acceptClients();
+    if (mClients.empty()) {
+        // Nobody watching: skip the encoding and start over for the next subscriber
+        mEncoder.reset();
+        return;
+    }
+    if (mEncoder.needsReset(simulation)) {
+        mEncoder.reset();
+        for (Client& client : mClients) {
+            client.synced = false;
+        }
+    }
+    if (!mEncoder.hasNewTick(simulation)) {
+        return;
+    }
+
+    mDelta.clear();
+    mEncoder.encodeDelta(simulation, mDelta);
+    mDeltaCount++;
+    mDeltaBytes += mDelta.size();
+
+    mKeyframe.clear();
+    for (Client& client : mClients) {
+        if (client.synced) {
+            client.pending.insert(client.pending.end(), mDelta.begin(), mDelta.end());
+        }
+        else {
+            // New subscribers (and everyone after a new run starts) get the
+            // full state once, then deltas on top of it
+            if (mKeyframe.empty()) {
+                mEncoder.encodeKeyframe(simulation, mKeyframe);
+            }
+            client.pending.insert(client.pending.end(), mKeyframe.begin(), mKeyframe.end());
+            client.synced = true;
+        }
+        flush(client);
+    }
+    mClients.erase(std::remove_if(mClients.begin(), mClients.end(), [](const Client& client) { return client.dropped; }),
+        mClients.end());
+}
+
+bool runSpectatorClient(const std::string& host, unsigned short port, float seconds, std::ostream& out) {
+    sf::TcpSocket socket;
+    if (socket.connect(sf::IpAddress(host), port, sf::seconds(5.0f)) != sf::Socket::Done) {
+        out << "Could not connect to " << host << ":" << port << "\n";
+        return false;
+    }
+    socket.setBlocking(false);
+
+    SpectatorView view;
+    std::uint8_t buffer[4096];
+    sf::Clock total;
+    sf::Clock interval;
+    std::uint64_t intervalBytes = 0;
+    std::uint64_t intervalStartTick = 0;
+    bool ok = true;
+    bool connected = true;
+
+    while (connected && (seconds <= 0.0f || total.getElapsedTime().asSeconds() < seconds)) {
+        std::size_t received = 0;
+        const sf::Socket::Status status = socket.receive(buffer, sizeof(buffer), received);
+        if (status == sf::Socket::Done) {
+            const bool wasSynced = view.isSynced();
+            ok = view.feed(buffer, received) && ok;
+            intervalBytes += received;
+            if (!wasSynced && view.isSynced()) {
+                intervalStartTick = view.getTick(); // joined mid-run
+            }
+            continue;
+        }
+        if (status == sf::Socket::Disconnected || status == sf::Socket::Error) {
+            connected = false;
+        }
+        else {
+            sf::sleep(sf::milliseconds(2));
+        }
+
+        const float elapsed = interval.getElapsedTime().asSeconds();
+        if (elapsed >= 1.0f || !connected) {
+            const std::uint64_t ticks = view.getTick() > intervalStartTick ? view.getTick() - intervalStartTick : 0;
+            out << "tick " << view.getTick()
+                << "  lane " << view.getPlayerLane() << "  state " << view.getPlayerState()
+                << "  score " << view.getScore() << "  coins " << view.getCoins()
+                << "  entities " << view.getEntities().size()
+                << "  bytes/tick " << (ticks > 0 ? static_cast<double>(intervalBytes) / static_cast<double>(ticks) : 0.0)
+                << "  KB/s " << (elapsed > 0.0f ? static_cast<double>(intervalBytes) / 1024.0 / elapsed : 0.0)
+                << (view.isSynced() ? "" : "  (waiting for keyframe)") << "\n";
+            interval.restart();
+            intervalBytes = 0;
+            intervalStartTick = view.getTick();
+        }
+    }
+
+    const float elapsed = total.getElapsedTime().asSeconds();
+    out << "Received " << view.getByteCount() << " bytes in " << view.getMessageCount() << " messages over "
+        << elapsed << " s (" << (elapsed > 0.0f ? static_cast<double>(view.getByteCount()) / 1024.0 / elapsed : 0.0)
+        << " KB/s)" << (ok ? "" : ", with malformed messages") << "\n";
+    return ok;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "SpectatorStream.h"
+#include <SFML/Network.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Publishes the running game to spectators over TCP (SFML has no UNIX
+// sockets, so it binds localhost for cabinet-local screens). Everything is
+// non-blocking: publish() accepts new subscribers, encodes one delta and
+// hands each subscriber whatever its socket takes right now. A subscriber
+// that falls MAX_BACKLOG bytes behind is dropped instead of stalling the
+// game loop.
+class SpectatorServer {
+public:
+    static constexpr std::size_t MAX_CLIENTS = 64;
+    static constexpr std::size_t MAX_BACKLOG = 256 * 1024;
+
+    // Loopback only unless a wider 'address' is asked for explicitly.
+    bool listen(unsigned short port, const sf::IpAddress& address = sf::IpAddress::LocalHost);
+    bool isListening() const { return mListening; }
+
+    // Call once after every simulation tick.
+    void publish(const Simulation& simulation);
+
+    std::size_t getClientCount() const { return mClients.size(); }
+    std::uint64_t getDeltaCount() const { return mDeltaCount; }
+    std::uint64_t getDeltaBytes() const { return mDeltaBytes; }
+
+private:
+    struct Client {
+        std::unique_ptr<sf::TcpSocket> socket;
+        std::vector<std::uint8_t> pending; // queued bytes, sent from 'sentOffset'
+        std::size_t sentOffset = 0;
+        bool synced = false; // has been sent a keyframe of the current run
+        bool dropped = false;
+    };
+
+    void acceptClients();
+    void flush(Client& client);
+
+    sf::TcpListener mListener;
+    bool mListening = false;
+    std::vector<Client> mClients;
+    SpectatorEncoder mEncoder;
+    std::vector<std::uint8_t> mDelta;
+    std::vector<std::uint8_t> mKeyframe;
+    std::uint64_t mDeltaCount = 0;
+    std::uint64_t mDeltaBytes = 0;
+};
+
+// Headless subscriber: connects to a SpectatorServer, rebuilds the state
+// and prints it with bytes-per-tick and bandwidth once a second for
+// 'seconds' seconds (0 = until the server goes away). Returns false if it
+// could not connect or the stream was malformed.
+bool runSpectatorClient(const std::string& host, unsigned short port, float seconds, std::ostream& out);
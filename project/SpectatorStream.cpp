@@ -0,0 +1,357 @@
+#include "SpectatorStream.h"
+#include "LaneSystem.h"
+#include "Simulation.h"
+#include "Varint.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace SpectatorStream;
+
+namespace {
+    // Length prefix plus body; the body is built separately so its size is known.
+    void frame(const std::vector<std::uint8_t>& body, std::vector<std::uint8_t>& out) {
+        Varint::put(out, body.size());
+        out.insert(out.end(), body.begin(), body.end());
+    }
+
+    std::uint8_t entityCode(Archetype archetype, int kind, float x) {
+        return static_cast<std::uint8_t>(static_cast<int>(archetype) | (kind << 2) | (LaneSystem::getLaneIndex(x) << 5));
+    }
+
+    std::uint8_t playerBits(const Player& player) {
+        return static_cast<std::uint8_t>(player.getLane() | (static_cast<int>(player.getState()) << 2));
+    }
+
+    void putSpawn(std::vector<std::uint8_t>& out, std::uint8_t code, std::int32_t y) {
+        out.push_back(code);
+        Varint::put(out, static_cast<std::uint64_t>(std::max(0, y + SPAWN_Y_BIAS)));
+    }
+
+    // The whole message must be available: a frame longer than this is garbage.
+    const std::size_t kMaxMessageSize = 1 << 20;
+}
+
+template <typename Visit> void SpectatorEncoder::forEachLive(const EntityWorld& world, Visit visit) {
+    const EntityWorld::ObstacleTable& obstacles = world.getObstacles();
+    for (size_t i = 0; i < obstacles.size(); ++i) {
+        if (!obstacles.get<Status>(i).dead) {
+            const Position& position = obstacles.get<Position>(i);
+            visit(obstacles.get<EntityHandle>(i),
+                entityCode(Archetype::OBSTACLE, static_cast<int>(obstacles.get<ObstacleBehaviour>(i).type), position.x),
+                position.y);
+        }
+    }
+    const EntityWorld::PowerUpTable& powerUps = world.getPowerUps();
+    for (size_t i = 0; i < powerUps.size(); ++i) {
+        if (!powerUps.get<Status>(i).dead) {
+            const Position& position = powerUps.get<Position>(i);
+            visit(powerUps.get<EntityHandle>(i),
+                entityCode(Archetype::POWER_UP, static_cast<int>(powerUps.get<PowerUpBehaviour>(i).type), position.x),
+                position.y);
+        }
+    }
+    // Coins pulled by the magnet drift off their lane; spectators see them
+    // scroll straight until they are collected.
+    const CoinStore& coins = world.getCoins();
+    for (size_t i = 0; i < coins.size(); ++i) {
+        if (coins.isAlive(i) && coins.getPosition(i).y <= CoinStore::DESPAWN_Y) {
+            visit(coins.getHandle(i), entityCode(Archetype::COIN, 0, coins.getPosition(i).x), coins.getPosition(i).y);
+        }
+    }
+}
+
+bool SpectatorEncoder::needsReset(const Simulation& simulation) const {
+    return mStarted && (simulation.getSeed() != mSeed || simulation.getTickCount() < mTick);
+}
+
+void SpectatorEncoder::reset() {
+    *this = SpectatorEncoder();
+}
+
+bool SpectatorEncoder::hasNewTick(const Simulation& simulation) const {
+    return !mStarted || simulation.getTickCount() != mTick;
+}
+
+void SpectatorEncoder::encodeDelta(const Simulation& simulation, std::vector<std::uint8_t>& out) {
+    if (!mStarted) {
+        mSeed = simulation.getSeed();
+        mStarted = true;
+    }
+    const EntityWorld& world = simulation.getTrack().getWorld();
+
+    // Diff the live entities against the ones already announced
+    mEpoch++;
+    mSpawns.clear();
+    mDespawns.clear();
+    forEachLive(world, [this](EntityHandle handle, std::uint8_t code, float y) {
+        if (handle.index >= mTracked.size()) {
+            mTracked.resize(handle.index + 1, Tracked{ 0, 0, 0, false });
+        }
+        Tracked& tracked = mTracked[handle.index];
+        if (tracked.active && tracked.generation == handle.generation) {
+            tracked.epoch = mEpoch;
+            return;
+        }
+        if (tracked.active) {
+            mDespawns.push_back(tracked.id); // slot reused within one tick
+        }
+        tracked = Tracked{ handle.generation, mNextId++, mEpoch, true };
+        mSpawns.push_back(Spawn{ tracked.id, code, static_cast<std::int32_t>(std::lround(y)) });
+    });
+    for (Tracked& tracked : mTracked) {
+        if (tracked.active && tracked.epoch != mEpoch) {
+            tracked.active = false;
+            mDespawns.push_back(tracked.id);
+        }
+    }
+    std::sort(mDespawns.begin(), mDespawns.end());
+
+    mScrollTotal += world.getLastAdvance();
+    const std::uint64_t scroll = static_cast<std::uint64_t>(std::llround(mScrollTotal * SCROLL_SCALE));
+    const std::uint64_t tick = simulation.getTickCount();
+
+    const Player& player = simulation.getPlayer();
+    const std::uint8_t bits = playerBits(player);
+    const std::int32_t playerY = static_cast<std::int32_t>(std::lround(player.getPosition().y));
+    const std::int64_t score = static_cast<std::int64_t>(simulation.getScore().getScore());
+    const std::int64_t coins = simulation.getScore().getCoins();
+
+    std::uint8_t flags = 0;
+    flags |= bits != mPlayerBits ? PLAYER_BITS : 0;
+    flags |= playerY != mPlayerY ? PLAYER_Y : 0;
+    flags |= score != mScore ? SCORE : 0;
+    flags |= coins != mCoins ? COINS : 0;
+    flags |= !mSpawns.empty() ? SPAWNS : 0;
+    flags |= !mDespawns.empty() ? DESPAWNS : 0;
+
+    mBody.clear();
+    mBody.push_back(static_cast<std::uint8_t>(MessageType::DELTA));
+    Varint::put(mBody, tick - mTick);
+    Varint::put(mBody, scroll - mScrollSent);
+    mBody.push_back(flags);
+    if (flags & PLAYER_BITS) {
+        mBody.push_back(bits);
+    }
+    if (flags & PLAYER_Y) {
+        Varint::putSigned(mBody, playerY - mPlayerY);
+    }
+    if (flags & SCORE) {
+        Varint::putSigned(mBody, score - mScore);
+    }
+    if (flags & COINS) {
+        Varint::putSigned(mBody, coins - mCoins);
+    }
+    if (flags & SPAWNS) {
+        Varint::put(mBody, mSpawns.size());
+        for (const Spawn& spawn : mSpawns) {
+            putSpawn(mBody, spawn.code, spawn.y);
+        }
+    }
+    if (flags & DESPAWNS) {
+        Varint::put(mBody, mDespawns.size());
+        std::uint32_t previous = 0;
+        for (std::uint32_t id : mDespawns) {
+            Varint::put(mBody, id - previous);
+            previous = id;
+        }
+    }
+    frame(mBody, out);
+
+    mTick = tick;
+    mScrollSent = scroll;
+    mPlayerBits = bits;
+    mPlayerY = playerY;
+    mScore = score;
+    mCoins = coins;
+}
+
+void SpectatorEncoder::encodeKeyframe(const Simulation& simulation, std::vector<std::uint8_t>& out) {
+    // Keyframes are rare (a subscriber joined or a run started), so reuse
+    // the spawn list as scratch rather than keep a copy of every entity.
+    mSpawns.clear();
+    forEachLive(simulation.getTrack().getWorld(), [this](EntityHandle handle, std::uint8_t code, float y) {
+        if (handle.index < mTracked.size() && mTracked[handle.index].active) {
+            mSpawns.push_back(Spawn{ mTracked[handle.index].id, code, static_cast<std::int32_t>(std::lround(y)) });
+        }
+    });
+    std::sort(mSpawns.begin(), mSpawns.end(), [](const Spawn& a, const Spawn& b) { return a.id < b.id; });
+
+    mBody.clear();
+    mBody.push_back(static_cast<std::uint8_t>(MessageType::KEYFRAME));
+    Varint::put(mBody, mTick);
+    mBody.push_back(mPlayerBits);
+    Varint::putSigned(mBody, mPlayerY);
+    Varint::putSigned(mBody, mScore);
+    Varint::putSigned(mBody, mCoins);
+    Varint::put(mBody, mNextId);
+    Varint::put(mBody, mSpawns.size());
+    std::uint32_t expected = 0;
+    for (const Spawn& spawn : mSpawns) {
+        Varint::put(mBody, spawn.id - expected);
+        putSpawn(mBody, spawn.code, spawn.y);
+        expected = spawn.id + 1;
+    }
+    frame(mBody, out);
+    mSpawns.clear();
+}
+
+bool SpectatorView::feed(const std::uint8_t* data, std::size_t size) {
+    mBytes += size;
+    mPending.insert(mPending.end(), data, data + size);
+
+    bool ok = true;
+    std::size_t offset = 0;
+    while (offset < mPending.size()) {
+        std::size_t cursor = offset;
+        std::uint64_t length;
+        if (!Varint::get(mPending.data(), mPending.size(), cursor, length)) {
+            ok = cursor - offset < 10; // otherwise the prefix itself is corrupt
+            break;
+        }
+        if (length == 0 || length > kMaxMessageSize) {
+            ok = false;
+            break;
+        }
+        if (mPending.size() - cursor < length) {
+            break; // rest of the message not here yet
+        }
+        mMessages++;
+        if (!apply(mPending.data() + cursor, static_cast<std::size_t>(length))) {
+            mSynced = false;
+            mEntities.clear();
+            ok = false;
+        }
+        offset = cursor + static_cast<std::size_t>(length);
+    }
+    if (!ok && offset < mPending.size()) {
+        mSynced = false;
+        mEntities.clear();
+        offset = mPending.size(); // the framing is lost; resync on the next keyframe
+    }
+    mPending.erase(mPending.begin(), mPending.begin() + static_cast<std::ptrdiff_t>(offset));
+    return ok;
+}
+
+bool SpectatorView::readSpawn(const std::uint8_t* data, std::size_t size, std::size_t& offset, std::uint32_t id) {
+    std::uint64_t y;
+    if (offset >= size) {
+        return false;
+    }
+    const std::uint8_t code = data[offset++];
+    if ((code & 3) > static_cast<int>(Archetype::COIN) || !Varint::get(data, size, offset, y)) {
+        return false;
+    }
+    Entity entity;
+    entity.id = id;
+    entity.archetype = static_cast<Archetype>(code & 3);
+    entity.kind = static_cast<std::uint8_t>((code >> 2) & 7);
+    entity.lane = static_cast<std::uint8_t>((code >> 5) & 3);
+    entity.trackY = static_cast<float>(static_cast<std::int64_t>(y) - SPAWN_Y_BIAS) - getScroll();
+    mEntities.push_back(entity);
+    return true;
+}
+
+bool SpectatorView::apply(const std::uint8_t* data, std::size_t size) {
+    std::size_t offset = 1;
+    std::uint64_t value;
+    std::int64_t signedValue;
+
+    if (data[0] == static_cast<std::uint8_t>(MessageType::KEYFRAME)) {
+        mEntities.clear();
+        mScroll = 0;
+        std::int64_t playerY, score, coins;
+        std::uint64_t nextId, count;
+        if (!Varint::get(data, size, offset, mTick) || offset >= size) {
+            return false;
+        }
+        mPlayerBits = data[offset++];
+        if (!Varint::getSigned(data, size, offset, playerY) || !Varint::getSigned(data, size, offset, score) ||
+            !Varint::getSigned(data, size, offset, coins) || !Varint::get(data, size, offset, nextId) ||
+            !Varint::get(data, size, offset, count)) {
+            return false;
+        }
+        mPlayerY = static_cast<std::int32_t>(playerY);
+        mScore = score;
+        mCoins = coins;
+        std::uint32_t expected = 0;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            if (!Varint::get(data, size, offset, value) || !readSpawn(data, size, offset, expected + static_cast<std::uint32_t>(value))) {
+                return false;
+            }
+            expected = mEntities.back().id + 1;
+        }
+        mNextId = static_cast<std::uint32_t>(nextId);
+        mSynced = true;
+        return offset == size;
+    }
+
+    if (data[0] != static_cast<std::uint8_t>(MessageType::DELTA)) {
+        return false;
+    }
+    if (!mSynced) {
+        return true; // deltas mean nothing until the first keyframe
+    }
+    std::uint64_t ticks, scroll;
+    if (!Varint::get(data, size, offset, ticks) || !Varint::get(data, size, offset, scroll) || offset >= size) {
+        return false;
+    }
+    mTick += ticks;
+    mScroll += scroll;
+    const std::uint8_t flags = data[offset++];
+    if (flags & PLAYER_BITS) {
+        if (offset >= size) {
+            return false;
+        }
+        mPlayerBits = data[offset++];
+    }
+    if (flags & PLAYER_Y) {
+        if (!Varint::getSigned(data, size, offset, signedValue)) {
+            return false;
+        }
+        mPlayerY += static_cast<std::int32_t>(signedValue);
+    }
+    if (flags & SCORE) {
+        if (!Varint::getSigned(data, size, offset, signedValue)) {
+            return false;
+        }
+        mScore += signedValue;
+    }
+    if (flags & COINS) {
+        if (!Varint::getSigned(data, size, offset, signedValue)) {
+            return false;
+        }
+        mCoins += signedValue;
+    }
+    if (flags & SPAWNS) {
+        std::uint64_t count;
+        if (!Varint::get(data, size, offset, count)) {
+            return false;
+        }
+        for (std::uint64_t i = 0; i < count; ++i) {
+            if (!readSpawn(data, size, offset, mNextId++)) {
+                return false;
+            }
+        }
+    }
+    if (flags & DESPAWNS) {
+        std::uint64_t count;
+        if (!Varint::get(data, size, offset, count)) {
+            return false;
+        }
+        std::uint32_t id = 0;
+        auto searchFrom = mEntities.begin();
+        for (std::uint64_t i = 0; i < count; ++i) {
+            if (!Varint::get(data, size, offset, value)) {
+                return false;
+            }
+            id += static_cast<std::uint32_t>(value);
+            // Ids ascend on both sides, so each search starts where the last ended
+            searchFrom = std::lower_bound(searchFrom, mEntities.end(), id,
+                [](const Entity& entity, std::uint32_t target) { return entity.id < target; });
+            if (searchFrom != mEntities.end() && searchFrom->id == id) {
+                searchFrom = mEntities.erase(searchFrom);
+            }
+        }
+    }
+    return offset == size;
+}
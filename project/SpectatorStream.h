@@ -0,0 +1,145 @@
+#pragma once
+#include "EntityHandle.h"
+#include "EntityWorld.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Simulation;
+
+// Wire format for mirroring a live run to spectators. Every message is
+// framed by its varint byte length and starts with a type byte:
+//
+//   KEYFRAME  varint tick, player byte, zigzag player y, zigzag score,
+//             zigzag coins, varint next id, varint entity count, then
+//             per entity a varint id gap and a spawn record
+//   DELTA     varint ticks since the last message, varint scroll in
+//             1/8 px, flags byte, then only the parts the flags name:
+//             player byte, zigzag player y delta, zigzag score delta,
+//             zigzag coins delta, spawn count + spawn records, despawn
+//             count + despawned ids
+//
+// The player byte packs lane | state << 2. Entities get consecutive stream
+// ids in spawn order, so a DELTA's spawns take the next ids implicitly and
+// only a keyframe spells out the gaps. A spawn record is a code byte
+// packing archetype | kind << 2 | lane << 5 and the varint y in whole
+// pixels biased by SPAWN_Y_BIAS. Despawned ids go out ascending, each as a
+// delta from the one before. Entities only scroll between spawn and
+// despawn, so a quiet tick is about five bytes.
+namespace SpectatorStream {
+    enum class MessageType : std::uint8_t { KEYFRAME, DELTA };
+
+    enum DeltaFlags : std::uint8_t {
+        PLAYER_BITS = 1 << 0,
+        PLAYER_Y = 1 << 1,
+        SCORE = 1 << 2,
+        COINS = 1 << 3,
+        SPAWNS = 1 << 4,
+        DESPAWNS = 1 << 5
+    };
+
+    constexpr float SCROLL_SCALE = 8.0f; // scroll steps per pixel
+    constexpr int SPAWN_Y_BIAS = 1024; // keeps spawn y (from -300 up) unsigned
+}
+
+// Turns a Simulation into the stream. encodeDelta() must see every tick
+// (the scroll is taken from the last tick's track advance); it tracks what
+// it has sent so deltas never drift from what a subscriber rebuilt.
+class SpectatorEncoder {
+public:
+    // True when 'simulation' is not the run this encoder has been following
+    // (a new run started); reset() and send everyone a keyframe.
+    bool needsReset(const Simulation& simulation) const;
+    void reset();
+
+    // True when the simulation has ticked since the last encodeDelta().
+    bool hasNewTick(const Simulation& simulation) const;
+
+    // Appends one framed DELTA with the changes since the last call.
+    void encodeDelta(const Simulation& simulation, std::vector<std::uint8_t>& out);
+
+    // Appends one framed KEYFRAME of the state as of the last encodeDelta();
+    // the deltas that follow apply on top of it.
+    void encodeKeyframe(const Simulation& simulation, std::vector<std::uint8_t>& out);
+
+private:
+    struct Tracked {
+        std::uint32_t generation;
+        std::uint32_t id;
+        std::uint32_t epoch; // last encodeDelta() that saw it alive
+        bool active;
+    };
+
+    struct Spawn {
+        std::uint32_t id;
+        std::uint8_t code;
+        std::int32_t y;
+    };
+
+    template <typename Visit> static void forEachLive(const EntityWorld& world, Visit visit);
+
+    std::vector<Tracked> mTracked; // indexed by handle index
+    std::vector<Spawn> mSpawns;
+    std::vector<std::uint32_t> mDespawns;
+    std::vector<std::uint8_t> mBody;
+    std::uint32_t mEpoch = 0;
+    std::uint32_t mNextId = 0;
+    unsigned int mSeed = 0;
+    std::uint64_t mTick = 0;
+    std::uint64_t mScrollSent = 0; // scroll steps sent so far
+    double mScrollTotal = 0.0; // true scroll since the reset, in pixels
+    std::int32_t mPlayerY = 0;
+    std::uint8_t mPlayerBits = 0;
+    std::int64_t mScore = 0;
+    std::int64_t mCoins = 0;
+    bool mStarted = false;
+};
+
+// Rebuilds the mirrored state on the subscriber side. Bytes may be fed in
+// any chunking; whole messages are applied as they complete.
+class SpectatorView {
+public:
+    struct Entity {
+        std::uint32_t id;
+        Archetype archetype;
+        std::uint8_t kind;
+        std::uint8_t lane;
+        float trackY; // y minus the scroll when it was placed
+    };
+
+    // Returns false on a malformed message; the view then drops everything
+    // until the next keyframe.
+    bool feed(const std::uint8_t* data, std::size_t size);
+
+    bool isSynced() const { return mSynced; }
+    std::uint64_t getTick() const { return mTick; }
+    int getPlayerLane() const { return mPlayerBits & 3; }
+    int getPlayerState() const { return (mPlayerBits >> 2) & 3; }
+    float getPlayerY() const { return static_cast<float>(mPlayerY); }
+    std::int64_t getScore() const { return mScore; }
+    std::int64_t getCoins() const { return mCoins; }
+
+    const std::vector<Entity>& getEntities() const { return mEntities; }
+    float getScroll() const { return static_cast<float>(mScroll) / SpectatorStream::SCROLL_SCALE; }
+    float getEntityY(const Entity& entity) const { return entity.trackY + getScroll(); }
+
+    std::uint64_t getMessageCount() const { return mMessages; }
+    std::uint64_t getByteCount() const { return mBytes; }
+
+private:
+    bool apply(const std::uint8_t* data, std::size_t size);
+    bool readSpawn(const std::uint8_t* data, std::size_t size, std::size_t& offset, std::uint32_t id);
+
+    std::vector<std::uint8_t> mPending; // bytes of an incomplete message
+    std::vector<Entity> mEntities; // ascending ids
+    std::uint64_t mTick = 0;
+    std::uint64_t mScroll = 0;
+    std::int32_t mPlayerY = 0;
+    std::uint8_t mPlayerBits = 0;
+    std::int64_t mScore = 0;
+    std::int64_t mCoins = 0;
+    std::uint32_t mNextId = 0;
+    bool mSynced = false;
+    std::uint64_t mMessages = 0;
+    std::uint64_t mBytes = 0;
+};
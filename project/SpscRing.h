@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Fixed-size queue between exactly one producer thread and one consumer
+// thread. Both sides are wait-free: a push or pop is a few loads and one
+// release store, and a full or empty ring is reported instead of waited on.
+//
+// Each index is written by one side only and sits on its own cache line,
+// next to that side's cached copy of the other index, so the two threads
+// only share a line when one of them finds its cached copy out of date.
+template <typename T>
+class SpscRing {
+public:
+    // Capacity is rounded up to a power of two.
+    explicit SpscRing(std::size_t capacity) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mSlots.resize(size);
+        mMask = size - 1;
+    }
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    std::size_t capacity() const { return mSlots.size(); }
+    // Either side; only a snapshot while the other side is running.
+    std::size_t size() const {
+        const std::size_t tail = mTail.value.load(std::memory_order_acquire);
+        return mHead.value.load(std::memory_order_acquire) - tail;
+    }
+
+    // Producer only. Returns false if the ring is full.
+    bool tryPush(const T& value) {
+        const std::size_t head = mHead.value.load(std::memory_order_relaxed);
+        if (head - mHead.cachedOther == mSlots.size()) {
+            mHead.cachedOther = mTail.value.load(std::memory_order_acquire);
+            if (head - mHead.cachedOther == mSlots.size()) {
+                return false;
+            }
+        }
+        mSlots[head & mMask] = value;
+        mHead.value.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. The oldest value, or null if the ring is empty; stays
+    // valid until pop().
+    const T* front() {
+        const std::size_t tail = mTail.value.load(std::memory_order_relaxed);
+        if (tail == mTail.cachedOther) {
+            mTail.cachedOther = mHead.value.load(std::memory_order_acquire);
+            if (tail == mTail.cachedOther) {
+                return nullptr;
+            }
+        }
+        return &mSlots[tail & mMask];
+    }
+
+    // Consumer only, after front() returned a value.
+    void pop() { mTail.value.store(mTail.value.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer only: visits every queued value, oldest first, without
+    // removing any.
+    template <typename Visit> void forEach(Visit visit) const {
+        const std::size_t head = mHead.value.load(std::memory_order_acquire);
+        for (std::size_t i = mTail.value.load(std::memory_order_relaxed); i != head; ++i) {
+            visit(mSlots[i & mMask]);
+        }
+    }
+
+    // Consumer only: drops everything queued so far.
+    void clear() {
+        mTail.cachedOther = mHead.value.load(std::memory_order_acquire);
+        mTail.value.store(mTail.cachedOther, std::memory_order_release);
+    }
+
+private:
+    struct alignas(64) Index {
+        std::atomic<std::size_t> value{ 0 };
+        std::size_t cachedOther = 0; // the other side's index as last seen
+    };
+
+    std::vector<T> mSlots;
+    std::size_t mMask;
+    Index mHead; // next slot to write, owned by the producer
+    Index mTail; // next slot to read, owned by the consumer
+};
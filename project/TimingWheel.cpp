@@ -0,0 +1,178 @@
+#include "TimingWheel.h"
+
+namespace {
+    const std::uint32_t NONE = TimerHandle::INVALID_INDEX;
+    const std::uint32_t SLOT_MASK = TimingWheel::SLOTS - 1;
+    // Furthest ahead the top level can tell apart
+    const std::uint64_t MAX_DELTA = (1ull << (TimingWheel::LEVEL_BITS * TimingWheel::LEVELS)) - 1;
+}
+
+void TimingWheel::reserve(std::size_t capacity) {
+    mTimers.reserve(capacity);
+    mDue.reserve(capacity);
+}
+
+void TimingWheel::clear() {
+    mTimers.clear();
+    mSlots.fill(NONE);
+    mFreeHead = NONE;
+    mTick = 0;
+    mSequence = 0;
+    mPending = 0;
+    mDue.clear();
+}
+
+TimerHandle TimingWheel::schedule(std::uint64_t delay, std::uint16_t event) {
+    return scheduleAt(mTick + std::max<std::uint64_t>(delay, 1), event);
+}
+
+TimerHandle TimingWheel::scheduleAt(std::uint64_t tick, std::uint16_t event) {
+    std::uint32_t index = mFreeHead;
+    if (index != NONE) {
+        mFreeHead = mTimers[index].next;
+    }
+    else {
+        index = static_cast<std::uint32_t>(mTimers.size());
+        mTimers.emplace_back();
+        if (mDue.capacity() < mTimers.size()) {
+            mDue.reserve(mTimers.capacity());
+        }
+    }
+    Timer& timer = mTimers[index];
+    timer.due = std::max(tick, mTick + 1);
+    timer.sequence = mSequence++;
+    timer.event = event;
+    timer.state = PENDING;
+    link(index);
+    mPending++;
+    return TimerHandle{ index, timer.generation };
+}
+
+bool TimingWheel::cancel(TimerHandle handle) {
+    if (!isPending(handle)) {
+        return false;
+    }
+    if (mTimers[handle.index].state == PENDING) {
+        unlink(handle.index);
+    }
+    release(handle.index);
+    return true;
+}
+
+bool TimingWheel::isPending(TimerHandle handle) const {
+    return handle.index < mTimers.size() && mTimers[handle.index].generation == handle.generation &&
+        mTimers[handle.index].state != FREE;
+}
+
+void TimingWheel::collectDue() {
+    mTick++;
+    // Each time a level's slot index wraps, the next level's current slot
+    // is close enough to be filed one level down
+    const std::uint32_t slot = static_cast<std::uint32_t>(mTick) & SLOT_MASK;
+    for (int level = 1; level < LEVELS; ++level) {
+        const std::uint32_t below = static_cast<std::uint32_t>(mTick >> (LEVEL_BITS * (level - 1))) & SLOT_MASK;
+        if (below != 0) {
+            break;
+        }
+        cascade(level, static_cast<std::uint32_t>(mTick >> (LEVEL_BITS * level)) & SLOT_MASK);
+    }
+
+    std::uint32_t index = mSlots[slot];
+    mSlots[slot] = NONE;
+    while (index != NONE) {
+        Timer& timer = mTimers[index];
+        timer.state = FIRING;
+        mDue.push_back(index);
+        index = timer.next;
+    }
+    if (mDue.size() > 1) {
+        std::sort(mDue.begin(), mDue.end(), [this](std::uint32_t a, std::uint32_t b) {
+            const Timer& left = mTimers[a];
+            const Timer& right = mTimers[b];
+            return left.event != right.event ? left.event < right.event : left.sequence < right.sequence;
+        });
+    }
+}
+
+void TimingWheel::cascade(int level, std::uint32_t slot) {
+    std::uint32_t index = mSlots[level * SLOTS + slot];
+    mSlots[level * SLOTS + slot] = NONE;
+    while (index != NONE) {
+        const std::uint32_t next = mTimers[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+void TimingWheel::link(std::uint32_t index) {
+    Timer& timer = mTimers[index];
+    // Only reached with due >= mTick: from scheduleAt() (due > mTick) or
+    // from cascade(), which runs before this tick's slot is collected
+    const std::uint64_t delta = std::min(timer.due - mTick, MAX_DELTA);
+    int level = 0;
+    while (level + 1 < LEVELS && delta >= (1ull << (LEVEL_BITS * (level + 1)))) {
+        level++;
+    }
+    timer.level = static_cast<std::uint8_t>(level);
+    timer.slot = static_cast<std::uint8_t>(((mTick + delta) >> (LEVEL_BITS * level)) & SLOT_MASK);
+
+    std::uint32_t& head = mSlots[level * SLOTS + timer.slot];
+    timer.prev = NONE;
+    timer.next = head;
+    if (head != NONE) {
+        mTimers[head].prev = index;
+    }
+    head = index;
+}
+
+void TimingWheel::unlink(std::uint32_t index) {
+    Timer& timer = mTimers[index];
+    if (timer.prev != NONE) {
+        mTimers[timer.prev].next = timer.next;
+    }
+    else {
+        mSlots[timer.level * SLOTS + timer.slot] = timer.next;
+    }
+    if (timer.next != NONE) {
+        mTimers[timer.next].prev = timer.prev;
+    }
+}
+
+void TimingWheel::release(std::uint32_t index) {
+    Timer& timer = mTimers[index];
+    timer.state = FREE;
+    timer.generation++;
+    timer.prev = NONE;
+    timer.next = mFreeHead;
+    mFreeHead = index;
+    mPending--;
+}
+
+void TimingWheel::saveState(SnapshotWriter& writer) const {
+    writer.value(mTick);
+    writer.value(mSequence);
+    writer.value(mFreeHead);
+    writer.values(mTimers);
+}
+
+bool TimingWheel::loadState(SnapshotReader& reader) {
+    if (!reader.value(mTick) || !reader.value(mSequence) || !reader.value(mFreeHead) || !reader.values(mTimers)) {
+        return false;
+    }
+    // Slot lists are rebuilt rather than stored: any valid filing fires on
+    // the same tick, and same-tick order comes from the sequence numbers
+    mSlots.fill(NONE);
+    mPending = 0;
+    for (std::uint32_t index = 0; index < mTimers.size(); ++index) {
+        if (mTimers[index].state != FREE) {
+            mTimers[index].state = PENDING;
+            link(index);
+            mPending++;
+        }
+    }
+    mDue.clear();
+    if (mDue.capacity() < mTimers.size()) {
+        mDue.reserve(mTimers.capacity());
+    }
+    return mFreeHead == NONE || mFreeHead < mTimers.size();
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include "Snapshot.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Names a scheduled timer. 'generation' is bumped whenever the timer fires
+// or is cancelled, so a handle kept past that no longer resolves.
+struct TimerHandle {
+    static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    std::uint32_t index = INVALID_INDEX;
+    std::uint32_t generation = 0;
+
+    bool isValid() const { return index != INVALID_INDEX; }
+    bool operator==(const TimerHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const TimerHandle& other) const { return !(*this == other); }
+};
+
+// Hierarchical timing wheel over whole ticks. Four levels of 64 slots cover
+// 64, 4096, 262144 and 16.7M ticks ahead; a timer sits in the coarsest slot
+// that still separates it from now and drops a level each time its slot
+// comes round (timers further out than the top level wait there and are
+// re-filed). Scheduling, cancelling and firing are O(1) per timer, and a
+// tick with nothing due costs an index increment and an empty-slot check.
+//
+// Timers carry a small event code rather than a callback so the wheel stays
+// plain data for snapshots and copies; advance() hands due codes to the
+// owner's dispatch function. Timers due on the same tick fire in event
+// order, then in the order they were scheduled, so runs stay deterministic.
+class TimingWheel {
+public:
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr int LEVELS = 4;
+    static constexpr std::uint32_t SLOTS = 1u << LEVEL_BITS;
+
+    explicit TimingWheel(std::size_t capacity = 0) {
+        mSlots.fill(TimerHandle::INVALID_INDEX);
+        reserve(capacity);
+    }
+
+    // Room for 'capacity' pending timers before schedule() allocates.
+    void reserve(std::size_t capacity);
+    // Drops every timer and winds the wheel back to tick 0.
+    void clear();
+
+    // Ticks advanced so far.
+    std::uint64_t getTick() const { return mTick; }
+    std::size_t getPendingCount() const { return mPending; }
+
+    // Fires 'event' 'delay' ticks from now. A delay of 0 counts as 1: the
+    // earliest a timer can fire is the next advance().
+    TimerHandle schedule(std::uint64_t delay, std::uint16_t event);
+    // Fires 'event' on the given absolute tick, or the next one if that has passed.
+    TimerHandle scheduleAt(std::uint64_t tick, std::uint16_t event);
+
+    // Returns false if the timer already fired or was cancelled.
+    bool cancel(TimerHandle handle);
+    bool isPending(TimerHandle handle) const;
+    // The tick a pending timer fires on.
+    std::uint64_t getDueTick(TimerHandle handle) const { return mTimers[handle.index].due; }
+
+    // Moves to the next tick and calls dispatch(event) for each timer due on
+    // it. dispatch may schedule and cancel timers, including ones due on
+    // this same tick that have not fired yet.
+    template <typename Dispatch> void advance(Dispatch dispatch) {
+        collectDue();
+        for (std::uint32_t index : mDue) {
+            Timer& timer = mTimers[index];
+            if (timer.state != FIRING) {
+                continue; // cancelled by an earlier timer's dispatch
+            }
+            const std::uint16_t event = timer.event;
+            release(index);
+            dispatch(event);
+        }
+        mDue.clear();
+    }
+
+    // Pending timers and the tick count; handles stay valid across a load.
+    void saveState(SnapshotWriter& writer) const;
+    bool loadState(SnapshotReader& reader);
+
+private:
+    enum State : std::uint8_t { FREE, PENDING, FIRING };
+
+    struct Timer {
+        std::uint64_t due = 0;
+        std::uint64_t sequence = 0; // schedule order, for same-tick ties
+        std::uint32_t generation = 0;
+        std::uint32_t next = TimerHandle::INVALID_INDEX; // slot list, or free list
+        std::uint32_t prev = TimerHandle::INVALID_INDEX;
+        std::uint16_t event = 0;
+        std::uint8_t state = FREE;
+        std::uint8_t slot = 0; // index into mSlots is level * SLOTS + slot
+        std::uint8_t level = 0;
+    };
+
+    void collectDue();
+    void cascade(int level, std::uint32_t slot);
+    void link(std::uint32_t index);
+    void unlink(std::uint32_t index);
+    void release(std::uint32_t index);
+
+    std::vector<Timer> mTimers;
+    std::array<std::uint32_t, LEVELS * SLOTS> mSlots; // list heads
+    std::uint32_t mFreeHead = TimerHandle::INVALID_INDEX;
+    std::uint64_t mTick = 0;
+    std::uint64_t mSequence = 0;
+    std::size_t mPending = 0;
+    std::vector<std::uint32_t> mDue; // this tick's timers while advance() runs
+};
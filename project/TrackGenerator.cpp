@@ -0,0 +1,382 @@
+#include "TrackGenerator.h"
+#include "LaneSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <type_traits>
+
+namespace {
+    const float DIFFICULTY_INTERVAL = 5.0f;
+    const float SPAWN_Y = -200.0f;
+    // How long an idle or stalled producer sleeps before looking again
+    const std::chrono::microseconds kProducerNap(500);
+
+    // Lane layouts an unpassable spawn is retried with, as old lane -> new
+    // lane: as decided, mirrored, then shifted one and two lanes over.
+    const std::array<std::array<int, LaneSystem::LANE_COUNT>, 4> kLaneMaps = { {
+        { 0, 1, 2 }, { 2, 1, 0 }, { 1, 2, 0 }, { 2, 0, 1 }
+    } };
+
+    // Ticks until a timer restarted at 0 and advanced by 'dt' each tick
+    // passes 'interval' ('inclusive': reaches it). Sums in float exactly as
+    // the old per-frame accumulators did, so spawns land on the same ticks
+    // and existing replays still verify.
+    std::uint64_t ticksToReach(float interval, float dt, bool inclusive) {
+        if (dt <= 0.0f) {
+            return 1;
+        }
+        float elapsed = 0.0f;
+        std::uint64_t ticks = 0;
+        do {
+            elapsed += dt;
+            ticks++;
+        } while (inclusive ? elapsed < interval : elapsed <= interval);
+        return ticks;
+    }
+}
+
+TrackGenerator::TrackGenerator(std::size_t patterns, unsigned int seed, const ChunkLibrary* chunks)
+    : mPatterns(mSpawns, patterns), mChunks(chunks), mTimers(2 * TRACK_EVENT_COUNT), mRng(seed) {}
+
+void TrackGenerator::generate(float dt) {
+    mTick++;
+    mSpawns.setTick(mTick);
+
+    // Due ticks are worked out from the tick length, so a new one
+    // re-derives them all
+    if (dt != mTickSeconds) {
+        mTickSeconds = dt;
+        for (int event = 0; event < TRACK_EVENT_COUNT; ++event) {
+            armTimer(static_cast<TrackEvent>(event));
+        }
+    }
+
+    // The world scrolls at the speed from before this tick's difficulty step
+    mGrid.advance(dt);
+    const std::size_t first = mSpawns.getRecords().size();
+    mPatterns.update(dt, mGameSpeed * dt);
+    // A scripted stage only makes sense where its script put it
+    admit(first, false);
+    mChunkRemaining = std::max(0.0f, mChunkRemaining - mGameSpeed * dt);
+    mTimers.advance([this](std::uint16_t event) { onTimer(event); });
+}
+
+void TrackGenerator::setGameSpeed(float speed) {
+    if (speed == mGameSpeed) {
+        return;
+    }
+    mGameSpeed = speed;
+    mSpawns.setGameSpeed(speed);
+    // Spawn intervals shrink with speed; pending spawns are re-timed
+    for (TrackEvent event : { SPAWN_OBSTACLE, SPAWN_COIN, SPAWN_POWER_UP }) {
+        armTimer(event);
+    }
+}
+
+void TrackGenerator::onTimer(std::uint16_t event) {
+    switch (event) {
+    case SPAWN_OBSTACLE:
+        spawnObstacle();
+        break;
+    case SPAWN_COIN:
+        spawnCoin();
+        break;
+    case SPAWN_POWER_UP:
+        spawnPowerUp();
+        break;
+    case DIFFICULTY_STEP:
+        startTimer(DIFFICULTY_STEP);
+        // Speed scaling
+        setGameSpeed(std::min(1100.0f, mGameSpeed + 25.0f));
+        return;
+    default:
+        return;
+    }
+    startTimer(static_cast<TrackEvent>(event));
+}
+
+void TrackGenerator::startTimer(TrackEvent event) {
+    mTimerStarts[event] = mTimers.getTick();
+    armTimer(event);
+}
+
+void TrackGenerator::armTimer(TrackEvent event) {
+    if (mTickSeconds <= 0.0f) {
+        return; // armed by the first generate()
+    }
+    // Spawns fire once their interval is reached, difficulty steps once it
+    // is passed. A shorter interval never fires in the past: at the earliest
+    // it fires on the next tick.
+    const std::uint64_t due = mTimerStarts[event] +
+        ticksToReach(timerInterval(event), mTickSeconds, event != DIFFICULTY_STEP);
+    mTimers.cancel(mTimerHandles[event]);
+    mTimerHandles[event] = mTimers.scheduleAt(due, event);
+}
+
+float TrackGenerator::timerInterval(TrackEvent event) const {
+    switch (event) {
+    case SPAWN_OBSTACLE:
+        return obstacleInterval();
+    case SPAWN_COIN:
+        return coinInterval();
+    case SPAWN_POWER_UP:
+        return powerUpInterval();
+    default:
+        return DIFFICULTY_INTERVAL;
+    }
+}
+
+void TrackGenerator::spawnObstacle() {
+    // A scripted pattern or an authored chunk has the track to itself while it runs
+    if (mPatterns.getActiveCount() > 0 || mChunkRemaining > 0.0f) {
+        return;
+    }
+    const std::size_t first = mSpawns.getRecords().size();
+    if (!mChunks || !spawnChunk()) {
+        spawnLayout();
+    }
+    admit(first, true);
+}
+
+void TrackGenerator::spawnLayout() {
+    std::uniform_int_distribution<int> patternDist(0, 3);
+    int pattern = patternDist(mRng);
+
+    if (pattern == 0) {
+        int lane = randomLane();
+        float x = LaneSystem::getLaneCenter(lane);
+        mSpawns.spawnObstacle(ObstacleRegistry::pick(mRng), x, SPAWN_Y);
+    }
+    else if (pattern == 1) {
+        // spawn two barriers leaving one safe lane
+        int blockedLane = randomLane();
+        int secondLane = (blockedLane + 2) % 3; // opposite lane to guarantee gap
+        float y = -150.0f;
+        mSpawns.spawnObstacle(ObstacleType::BARRIER, LaneSystem::getLaneCenter(blockedLane), y);
+        mSpawns.spawnObstacle(ObstacleType::BARRIER, LaneSystem::getLaneCenter(secondLane), y - 80.0f);
+    }
+    else if (pattern == 2) {
+        // train plus coin trail on other lane
+        int trainLane = randomLane();
+        mSpawns.spawnObstacle(ObstacleType::TRAIN, LaneSystem::getLaneCenter(trainLane), -220.0f);
+        int safeLane = randomLane(trainLane);
+        spawnCoinRow(safeLane, 4, 110.0f);
+    }
+    else {
+        // scripted pattern spawning over the next few seconds
+        std::uniform_int_distribution<int> scriptDist(0, static_cast<int>(PatternType::COUNT) - 1);
+        const PatternType type = static_cast<PatternType>(scriptDist(mRng));
+        PatternArgs args;
+        args.lane = randomLane();
+        args.seed = static_cast<std::uint32_t>(mRng());
+        mPatterns.launch(type, args);
+    }
+}
+
+bool TrackGenerator::spawnChunk() {
+    // Bands without chunks fall back to the built-in layouts
+    const std::size_t chunk = mChunks->pick(ChunkLibrary::bandForSpeed(mGameSpeed), mRng);
+    if (chunk == ChunkLibrary::NO_CHUNK) {
+        return false;
+    }
+    mChunkRemaining = mChunks->instantiate(chunk, mSpawns, SPAWN_Y);
+    return true;
+}
+
+void TrackGenerator::admit(std::size_t first, bool repairable) {
+    std::vector<SpawnRecord>& records = mSpawns.getRecords();
+    auto isObstacle = [](const SpawnRecord& record) { return record.kind == SpawnRecord::Kind::OBSTACLE; };
+    if (std::none_of(records.begin() + first, records.end(), isObstacle)) {
+        return;
+    }
+    mLaneChecks.checked++;
+
+    const std::uint16_t safe = mGrid.getSafeStates();
+    const std::size_t layouts = repairable ? kLaneMaps.size() : 1;
+    for (std::size_t layout = 0; layout < layouts; ++layout) {
+        const std::array<int, LaneSystem::LANE_COUNT>& lanes = kLaneMaps[layout];
+        LaneGrid trial = mGrid;
+        for (std::size_t i = first; i < records.size(); ++i) {
+            if (isObstacle(records[i])) {
+                const ObstacleSpec& spec = getObstacleSpec(static_cast<ObstacleType>(records[i].type));
+                trial.addObstacle(lanes[LaneSystem::getLaneIndex(records[i].x)], records[i].y, spec.height,
+                    mGameSpeed, spec.clearance);
+            }
+        }
+        if ((trial.getSafeStates() & safe) != safe) {
+            continue;
+        }
+        mGrid = trial;
+        if (layout > 0) {
+            // Coins and power-ups move with the obstacles they were laid out around
+            for (std::size_t i = first; i < records.size(); ++i) {
+                if (records[i].kind != SpawnRecord::Kind::GAME_SPEED) {
+                    records[i].x = LaneSystem::getLaneCenter(lanes[LaneSystem::getLaneIndex(records[i].x)]);
+                }
+            }
+            mLaneChecks.repaired++;
+        }
+        return;
+    }
+    records.erase(std::remove_if(records.begin() + first, records.end(), isObstacle), records.end());
+    mLaneChecks.rejected++;
+}
+
+void TrackGenerator::spawnCoin() {
+    int lane = randomLane();
+    spawnCoinRow(lane, 3, 80.0f);
+}
+
+void TrackGenerator::spawnPowerUp() {
+    int lane = randomLane();
+    float x = LaneSystem::getLaneCenter(lane);
+    float y = -50.0f;
+    mSpawns.spawnPowerUp(PowerUpRegistry::pick(mRng), x, y);
+}
+
+float TrackGenerator::obstacleInterval() const {
+    float interval = 1.6f - (mGameSpeed - 300.0f) / 1400.0f;
+    return std::max(0.55f, interval);
+}
+
+float TrackGenerator::coinInterval() const {
+    float interval = 0.7f - (mGameSpeed - 300.0f) / 2000.0f;
+    return std::max(0.25f, interval);
+}
+
+float TrackGenerator::powerUpInterval() const {
+    float interval = 12.0f - (mGameSpeed - 300.0f) / 500.0f;
+    return std::max(5.0f, interval);
+}
+
+void TrackGenerator::spawnCoinRow(int lane, int count, float spacing) {
+    float baseX = LaneSystem::getLaneCenter(lane);
+    float y = -60.0f;
+    for (int i = 0; i < count; ++i) {
+        mSpawns.spawnCoin(baseX, y - (i * spacing));
+    }
+}
+
+int TrackGenerator::randomLane(int excludeLane) {
+    // Fixed-size candidate list on the stack; this runs several times per second
+    std::array<int, LaneSystem::LANE_COUNT> lanes;
+    std::size_t count = 0;
+    for (int lane = 0; lane < LaneSystem::LANE_COUNT; ++lane) {
+        if (lane != excludeLane) {
+            lanes[count++] = lane;
+        }
+    }
+    std::uniform_int_distribution<std::size_t> dist(0, count - 1);
+    return lanes[dist(mRng)];
+}
+
+void TrackGenerator::saveState(SnapshotWriter& writer) const {
+    writer.value(mTick);
+    writer.value(mGameSpeed);
+    mTimers.saveState(writer);
+    writer.value(mTimerHandles);
+    writer.value(mTimerStarts);
+    writer.value(mTickSeconds);
+    mPatterns.saveState(writer);
+    writer.value(mChunkRemaining);
+    mGrid.saveState(writer);
+    writer.value(mLaneChecks);
+    // Snapshots are same-build only, so the engine goes in as raw bytes where
+    // the standard library makes it plain data, and as text elsewhere
+    if constexpr (std::is_trivially_copyable<std::mt19937>::value) {
+        writer.value(mRng);
+    }
+    else {
+        std::ostringstream rng;
+        rng << mRng;
+        writer.text(rng.str());
+    }
+}
+
+bool TrackGenerator::loadState(SnapshotReader& reader) {
+    mSpawns.clear();
+    if (!reader.value(mTick) || !reader.value(mGameSpeed) || !mTimers.loadState(reader) ||
+        !reader.value(mTimerHandles) || !reader.value(mTimerStarts) || !reader.value(mTickSeconds) ||
+        !mPatterns.loadState(reader) || !reader.value(mChunkRemaining) || !mGrid.loadState(reader) ||
+        !reader.value(mLaneChecks)) {
+        return false;
+    }
+    if constexpr (std::is_trivially_copyable<std::mt19937>::value) {
+        return reader.value(mRng);
+    }
+    else {
+        std::string rngState;
+        if (!reader.text(rngState)) {
+            return false;
+        }
+        std::istringstream rng(rngState);
+        rng >> mRng;
+        return !rng.fail();
+    }
+}
+
+TrackGeneratorThread::TrackGeneratorThread(TrackGenerator& generator, float tickSeconds, std::uint64_t aheadTicks,
+    std::uint64_t consumedTick, std::size_t capacity)
+    : mGenerator(generator), mTickSeconds(tickSeconds), mAheadTicks(aheadTicks), mRing(capacity),
+    mGenerated(generator.getTick()), mConsumed(consumedTick) {
+    mWorker = std::thread(&TrackGeneratorThread::run, this);
+}
+
+TrackGeneratorThread::~TrackGeneratorThread() {
+    mStop.store(true, std::memory_order_release);
+    mWorker.join();
+}
+
+void TrackGeneratorThread::run() {
+    while (!mStop.load(std::memory_order_acquire)) {
+        bool progressed;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            progressed = produce();
+        }
+        if (!progressed) {
+            std::this_thread::sleep_for(kProducerNap);
+        }
+    }
+}
+
+bool TrackGeneratorThread::produce() {
+    std::vector<SpawnRecord>& records = mGenerator.getSpawns().getRecords();
+    if (mPushed == records.size()) {
+        // Everything decided is queued: decide the next tick, if the world is near enough
+        if (mGenerator.getTick() >= mConsumed.load(std::memory_order_acquire) + mAheadTicks) {
+            return false;
+        }
+        records.clear();
+        mPushed = 0;
+        mGenerator.generate(mTickSeconds);
+    }
+    for (; mPushed < records.size(); ++mPushed) {
+        if (!mRing.tryPush(records[mPushed])) {
+            mProducerStalls.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    mGenerated.store(mGenerator.getTick(), std::memory_order_release);
+    return true;
+}
+
+TrackStreamStats TrackGeneratorThread::getStats() const {
+    TrackStreamStats stats;
+    stats.queued = mRing.size();
+    stats.capacity = mRing.capacity();
+    const std::uint64_t generated = mGenerated.load(std::memory_order_acquire);
+    const std::uint64_t consumed = mConsumed.load(std::memory_order_acquire);
+    stats.ticksAhead = generated > consumed ? generated - consumed : 0;
+    stats.producerStalls = mProducerStalls.load(std::memory_order_relaxed);
+    stats.consumerWaits = mConsumerWaits;
+    return stats;
+}
+
+void TrackGeneratorThread::restart(std::uint64_t consumedTick) {
+    mRing.clear();
+    mGenerator.getSpawns().clear();
+    mPushed = 0;
+    mGenerated.store(mGenerator.getTick(), std::memory_order_release);
+    mConsumed.store(consumedTick, std::memory_order_release);
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include "ChunkLibrary.h"
+#include "ConcreteObstacles.h"
+#include "ConcretePowerUps.h"
+#include "LaneGrid.h"
+#include "Snapshot.h"
+#include "SpawnPattern.h"
+#include "SpawnRecord.h"
+#include "SpscRing.h"
+#include "TimingWheel.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+
+// What the passability check did with the obstacle spawns it was given.
+struct LaneCheckStats {
+    std::uint64_t checked = 0;
+    std::uint64_t repaired = 0; // laid out mirrored or shifted instead
+    std::uint64_t rejected = 0; // obstacles dropped
+};
+
+// Every spawn decision of a track: the obstacle, coin and power-up timers,
+// difficulty steps, scripted patterns and authored chunks, all drawn from
+// one seeded RNG. It never looks at the world or the player, so a seed's
+// track is fixed in advance and can be decided ahead of the world - on
+// another thread with TrackGeneratorThread - as a stream of SpawnRecords.
+//
+// Every obstacle spawn goes through a LaneGrid of what is already on its
+// way, and is only kept if the track stays passable from every lane and
+// pose that was safe before.
+class TrackGenerator {
+public:
+    TrackGenerator(std::size_t patterns, unsigned int seed, const ChunkLibrary* chunks);
+    TrackGenerator(const TrackGenerator&) = delete;
+    TrackGenerator& operator=(const TrackGenerator&) = default;
+
+    // Decides tick getTick() + 1, 'dt' seconds long, appending its records
+    // to getSpawns().
+    void generate(float dt);
+
+    // Ticks decided so far.
+    std::uint64_t getTick() const { return mTick; }
+    SpawnList& getSpawns() { return mSpawns; }
+    float getGameSpeed() const { return mGameSpeed; }
+
+    // Spawns and difficulty steps are scheduled here; other track-side
+    // timers belong here too rather than in another per-frame accumulator.
+    const TimingWheel& getTimers() const { return mTimers; }
+    const PatternRunner& getPatterns() const { return mPatterns; }
+    const ChunkLibrary* getChunks() const { return mChunks; }
+    const LaneGrid& getLaneGrid() const { return mGrid; }
+    const LaneCheckStats& getLaneCheckStats() const { return mLaneChecks; }
+
+    // Everything but getSpawns(), which the owner saves as its own.
+    void saveState(SnapshotWriter& writer) const;
+    bool loadState(SnapshotReader& reader);
+
+private:
+    // Timer events. Ones due on the same tick fire in this order, the order
+    // update() used to check its accumulators in.
+    enum TrackEvent : std::uint16_t { SPAWN_OBSTACLE, SPAWN_COIN, SPAWN_POWER_UP, DIFFICULTY_STEP, TRACK_EVENT_COUNT };
+
+    void onTimer(std::uint16_t event);
+    void startTimer(TrackEvent event);
+    void armTimer(TrackEvent event);
+    float timerInterval(TrackEvent event) const;
+    void setGameSpeed(float speed);
+
+    void spawnObstacle();
+    void spawnLayout();
+    bool spawnChunk();
+    // Records from 'first' on are one decision. Keeps its obstacles if the
+    // track stays passable; else ('repairable') tries it mirrored and
+    // shifted across the lanes, and finally drops them.
+    void admit(std::size_t first, bool repairable);
+    void spawnCoin();
+    void spawnPowerUp();
+
+    float obstacleInterval() const;
+    float coinInterval() const;
+    float powerUpInterval() const;
+    void spawnCoinRow(int lane, int count, float spacing);
+    int randomLane(int excludeLane = -1);
+
+    SpawnList mSpawns;
+    PatternRunner mPatterns;
+    const ChunkLibrary* mChunks;
+    float mChunkRemaining = 0.0f; // pixels until the last chunk has scrolled past
+    LaneGrid mGrid;
+    LaneCheckStats mLaneChecks;
+
+    std::uint64_t mTick = 0;
+    float mGameSpeed = 300.0f;
+    TimingWheel mTimers;
+    // Per event: its pending timer and the tick its current interval began
+    std::array<TimerHandle, TRACK_EVENT_COUNT> mTimerHandles;
+    std::array<std::uint64_t, TRACK_EVENT_COUNT> mTimerStarts{};
+    float mTickSeconds = 0.0f; // 0 until the first generate()
+    std::mt19937 mRng;
+};
+
+// How far ahead a TrackGeneratorThread is and how often either side had
+// to wait for the other.
+struct TrackStreamStats {
+    std::size_t queued = 0;   // records in the ring
+    std::size_t capacity = 0; // ring slots
+    std::uint64_t ticksAhead = 0;
+    std::uint64_t producerStalls = 0; // times the producer found the ring full
+    std::uint64_t consumerWaits = 0;  // ticks the world had to wait for generation
+};
+
+// Runs a TrackGenerator on a worker thread up to 'aheadTicks' ticks ahead
+// of the world, pushing its records into a wait-free single-producer,
+// single-consumer ring. The consumer (the thread updating the world) pops
+// each tick's records when the tick comes and never takes a lock.
+//
+// The generator and the queue together hold every decision not yet
+// applied. The mutex only guards them against whilePaused(), used to copy,
+// save or replace that state; the producer holds it for one tick at a time.
+class TrackGeneratorThread {
+public:
+    TrackGeneratorThread(TrackGenerator& generator, float tickSeconds, std::uint64_t aheadTicks,
+        std::uint64_t consumedTick, std::size_t capacity);
+    TrackGeneratorThread(const TrackGeneratorThread&) = delete;
+    TrackGeneratorThread& operator=(const TrackGeneratorThread&) = delete;
+    ~TrackGeneratorThread();
+
+    // Consumer side: passes every record due by 'tick' to 'apply', oldest
+    // first, waiting for the producer if it has not decided that tick yet.
+    // Generation may then run up to 'aheadTicks' past 'tick'.
+    template <typename Apply> void take(std::uint64_t tick, Apply apply) {
+        bool waited = false;
+        for (;;) {
+            // Records are popped while waiting, so a tick bigger than the
+            // ring still gets through
+            const bool complete = mGenerated.load(std::memory_order_acquire) >= tick;
+            for (const SpawnRecord* record = mRing.front(); record && record->tick <= tick; record = mRing.front()) {
+                apply(*record);
+                mRing.pop();
+            }
+            if (complete) {
+                break;
+            }
+            mConsumerWaits += waited ? 0 : 1;
+            waited = true;
+            std::this_thread::yield();
+        }
+        mConsumed.store(tick, std::memory_order_release);
+    }
+    TrackStreamStats getStats() const;
+
+    // Runs 'action' with the producer stopped between ticks. Within it,
+    // forEachQueued() visits every decided record the consumer has not
+    // popped, and restart() drops them after the generator was replaced.
+    template <typename Action> void whilePaused(Action action) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        action();
+    }
+    template <typename Visit> void forEachQueued(Visit visit) const {
+        mRing.forEach(visit);
+        const std::vector<SpawnRecord>& records = mGenerator.getSpawns().getRecords();
+        for (std::size_t i = mPushed; i < records.size(); ++i) {
+            visit(records[i]);
+        }
+    }
+    void restart(std::uint64_t consumedTick);
+
+private:
+    void run();
+    bool produce();
+
+    TrackGenerator& mGenerator;
+    const float mTickSeconds;
+    const std::uint64_t mAheadTicks;
+    SpscRing<SpawnRecord> mRing;
+    std::size_t mPushed = 0; // records of the last generated tick already in the ring
+
+    std::mutex mMutex;
+    std::atomic<std::uint64_t> mGenerated; // ticks whose records are all queued
+    std::atomic<std::uint64_t> mConsumed;  // tick the world is at
+    std::atomic<std::uint64_t> mProducerStalls{ 0 };
+    std::uint64_t mConsumerWaits = 0;
+    std::atomic<bool> mStop{ false };
+    std::thread mWorker;
+};
@@ -1,49 +1,84 @@
-#pragma once
-#include "Coin.h"
-#include "ConcreteObstacles.h"
-#include "ConcretePowerUps.h"
-#include "GameList.h"
-#include "Obstacle.h"
-#include "PowerUp.h"
-#include <SFML/Graphics.hpp>
-#include <random>
-
-
-class TrackManager {
-public:
-	TrackManager();
-	void update(sf::Time dt);
-	void draw(sf::RenderWindow& window);
-
-	GameList<Obstacle>& getObstacles() { return mObstacles; }
-	GameList<PowerUp>& getPowerUps() { return mPowerUps; }
-	GameList<Coin>& getCoins() { return mCoins; }
-
-	float getGameSpeed() const { return mGameSpeed; }
-	void setGameSpeed(float speed) { mGameSpeed = speed; }
-	void increaseSpeed(float amount) { mGameSpeed += amount; }
-
-private:
-	void spawnObstacle();
-	void spawnCoin();
-	void spawnPowerUp();
-
-	GameList<Obstacle> mObstacles;
-	GameList<PowerUp> mPowerUps;
-	GameList<Coin> mCoins;
-
-	float mGameSpeed;
-	float mSpawnTimer;
-	float mCoinTimer;
-	float mPowerUpTimer;
-	float mDifficultyTimer;
-	std::mt19937 mRng;
-
-	float obstacleInterval() const;
-	float coinInterval() const;
-	float powerUpInterval() const;
-	void spawnCoinRow(int lane, int count, float spacing);
-	int randomLane(int excludeLane = -1);
-	ObstacleType randomObstacleType();
-};
-#pragma once
+#pragma once
+#include "ChunkLibrary.h"
+#include "EntitySystems.h"
+#include "EntityWorld.h"
+#include "SpawnRecord.h"
+#include "TrackGenerator.h"
+#include <SFML/System/Time.hpp>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+
+// How many entities of each archetype the world reserves up front. The
+// defaults cover the densest on-screen state at max speed, so the tables
+// never reallocate during a run.
+struct TrackCapacityConfig {
+	size_t obstacles = 64;
+	size_t powerUps = 8;
+	size_t coins = 96;
+	size_t patterns = 4; // scripted spawn patterns running at once
+};
+
+class TrackManager {
+public:
+	// 'seed' drives every spawn decision, so equal seeds and inputs give equal runs.
+	// With a chunk library, obstacles come from its chunks for the current
+	// difficulty band instead of the built-in layouts.
+	explicit TrackManager(const TrackCapacityConfig& capacity = TrackCapacityConfig(), unsigned int seed = std::random_device{}(),
+		const ChunkLibrary* chunks = nullptr);
+	// Takes on 'other's world and spawn decisions, including any 'other'
+	// has made ahead of its world. This track keeps its own generation mode.
+	// The first copy reserves room for a full worker queue, so later ones
+	// do not allocate.
+	TrackManager& operator=(const TrackManager& other);
+
+	void update(sf::Time dt);
+
+	// From now on spawn decisions are made up to 'aheadSeconds' ahead on a
+	// worker thread (see TrackGeneratorThread); update() then only applies
+	// them. Every later update() must be given 'tick'. Runs are the same
+	// either way.
+	void startBackgroundGeneration(sf::Time tick, float aheadSeconds = 3.0f);
+	bool isGeneratingInBackground() const { return mBackground != nullptr; }
+	// Queue depth and waits on either side; all zero without the worker.
+	TrackStreamStats getStreamStats() const;
+
+	EntityWorld& getWorld() { return mWorld; }
+	const EntityWorld& getWorld() const { return mWorld; }
+
+	float getGameSpeed() const { return mGameSpeed; }
+	const ChunkLibrary* getChunks() const { return mGenerator.getChunks(); }
+	// Ahead of the world and owned by the worker while it runs.
+	const TrackGenerator& getGenerator() const { return mGenerator; }
+
+	// World, speed, spawn decisions not applied yet and the generator.
+	// The chunk library itself is not saved.
+	void saveState(SnapshotWriter& writer) const;
+	bool loadState(SnapshotReader& reader);
+
+private:
+	static constexpr std::size_t STREAM_CAPACITY = 4096;
+
+	void apply(const SpawnRecord& record);
+	// Visits every decision not applied yet, in order: mPending, then the
+	// worker's queue (which must be paused).
+	template <typename Visit> void forEachPending(Visit visit) const {
+		for (std::size_t i = mPendingHead; i < mPending.size(); ++i) {
+			visit(mPending[i]);
+		}
+		if (mBackground) {
+			mBackground->forEachQueued(visit);
+		}
+	}
+
+	EntityWorld mWorld;
+	float mGameSpeed;
+	std::uint64_t mTick;
+	TrackGenerator mGenerator;
+	// Decisions from a copy or a snapshot, applied before any new ones
+	std::vector<SpawnRecord> mPending;
+	std::size_t mPendingHead;
+	std::unique_ptr<TrackGeneratorThread> mBackground; // uses mGenerator, so declared after it
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// LEB128-style variable-length integers shared by the replay file, the
+// spectator stream and the leaderboard protocol: 7 bits per byte, low bits
+// first, high bit set on every byte but the last.
+namespace Varint {
+    inline void put(std::vector<std::uint8_t>& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    // Signed values are zigzagged first so small negatives stay short.
+    inline void putSigned(std::vector<std::uint8_t>& out, std::int64_t value) {
+        put(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+    // Reads one value at 'offset' and moves past it. Returns false if the
+    // input ends first.
+    inline bool get(const std::uint8_t* in, std::size_t size, std::size_t& offset, std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && offset < size; shift += 7) {
+            const std::uint8_t byte = in[offset++];
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool get(const std::vector<std::uint8_t>& in, std::size_t& offset, std::uint64_t& value) {
+        return get(in.data(), in.size(), offset, value);
+    }
+
+    inline bool getSigned(const std::uint8_t* in, std::size_t size, std::size_t& offset, std::int64_t& value) {
+        std::uint64_t raw;
+        if (!get(in, size, offset, raw)) {
+            return false;
+        }
+        value = static_cast<std::int64_t>(raw >> 1) ^ -static_cast<std::int64_t>(raw & 1);
+        return true;
+    }
+}
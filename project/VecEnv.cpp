@@ -0,0 +1,224 @@
+#include "VecEnv.h"
+#include <algorithm>
+#include <random>
+
+namespace {
+    float clamp01(float value) {
+        return std::min(1.0f, std::max(0.0f, value));
+    }
+}
+
+void writeObservation(const Simulation& simulation, float* out) {
+    const std::size_t laneFeatures = VecEnv::LANE_FEATURES;
+    std::fill(out, out + VecEnv::OBSERVATION_SIZE, 0.0f);
+    int nearestType[LaneSystem::LANE_COUNT];
+    for (int lane = 0; lane < LaneSystem::LANE_COUNT; ++lane) {
+        out[lane * laneFeatures] = 1.0f;
+        out[lane * laneFeatures + laneFeatures - 2] = 1.0f;
+        out[lane * laneFeatures + laneFeatures - 1] = 1.0f;
+        nearestType[lane] = -1;
+    }
+
+    const Player& player = simulation.getPlayer();
+    const sf::FloatRect bounds = player.getBounds();
+    const float playerBottom = bounds.top + bounds.height;
+    // How far something spanning [top, bottom] still has to scroll to reach
+    // the player, or a negative value once it is behind the player
+    auto distance = [&](float top, float bottom) {
+        return top > playerBottom ? -1.0f : clamp01((bounds.top - bottom) / VecEnv::VIEW_DISTANCE);
+    };
+
+    const EntityWorld& world = simulation.getTrack().getWorld();
+    world.forEachIndexed([&](const LaneHit& hit) {
+        const float d = distance(hit.box.top, hit.box.top + hit.box.height);
+        if (d < 0.0f || !world.isAlive(hit.handle)) {
+            return;
+        }
+        const int lane = LaneSystem::getLaneIndex(hit.box.left + hit.box.width / 2.0f);
+        if (hit.archetype == static_cast<std::uint8_t>(Archetype::OBSTACLE)) {
+            if (d < out[lane * laneFeatures]) {
+                out[lane * laneFeatures] = d;
+                nearestType[lane] = hit.kind;
+            }
+        }
+        else {
+            float& nearest = out[lane * laneFeatures + laneFeatures - 2];
+            nearest = std::min(nearest, d);
+        }
+    });
+    for (int lane = 0; lane < LaneSystem::LANE_COUNT; ++lane) {
+        if (nearestType[lane] >= 0) {
+            out[lane * laneFeatures + 1 + nearestType[lane]] = 1.0f;
+        }
+    }
+
+    const CoinStore& coins = world.getCoins();
+    for (std::size_t i = 0; i < coins.size(); ++i) {
+        const sf::Vector2f position = coins.getPosition(i);
+        const float d = distance(position.y, position.y);
+        if (d >= 0.0f && coins.isAlive(i)) {
+            float& nearest = out[LaneSystem::getLaneIndex(position.x) * laneFeatures + laneFeatures - 1];
+            nearest = std::min(nearest, d);
+        }
+    }
+
+    float* self = out + VecEnv::PLAYER_OFFSET;
+    self[player.getLane()] = 1.0f;
+    self[3 + static_cast<int>(player.getState())] = 1.0f;
+    self[6] = clamp01((player.getGroundY() - player.getPosition().y) / VecEnv::JUMP_HEIGHT);
+    self[7] = clamp01(simulation.getTrack().getGameSpeed() / VecEnv::MAX_SPEED);
+    self[8] = player.isInvincible() ? 1.0f : 0.0f;
+    self[9] = player.isMagnetActive() ? 1.0f : 0.0f;
+    self[10] = player.isDoubleCoinActive() ? 1.0f : 0.0f;
+}
+
+VecEnv::VecEnv(const VecEnvConfig& config)
+    : mConfig(config),
+    mMaxTicks(static_cast<std::uint64_t>(config.maxSeconds * static_cast<float>(config.tickRate > 0 ? config.tickRate : 60))),
+    mEnvs(std::max<std::size_t>(1, config.envs)) {
+    const unsigned int threads = config.threads > 0 ? config.threads : std::thread::hardware_concurrency();
+    mThreads = std::max(1u, static_cast<unsigned int>(std::min<std::size_t>(threads, mEnvs.size())));
+    mWorkers.reserve(mThreads - 1);
+    for (unsigned int block = 1; block < mThreads; ++block) {
+        mWorkers.emplace_back(&VecEnv::workerLoop, this, block);
+    }
+}
+
+VecEnv::~VecEnv() {
+    runJob(Job::QUIT);
+    for (std::thread& worker : mWorkers) {
+        worker.join();
+    }
+}
+
+void VecEnv::reset(float* observations) {
+    mObservations = observations;
+    runJob(Job::RESET);
+}
+
+void VecEnv::step(const std::uint8_t* actions, float* observations, float* rewards, std::uint8_t* dones) {
+    mActions = actions;
+    mObservations = observations;
+    mRewards = rewards;
+    mDones = dones;
+    runJob(Job::STEP);
+}
+
+void VecEnv::startEpisode(std::size_t index) {
+    Env& env = mEnvs[index];
+    std::seed_seq sequence{ static_cast<std::uint32_t>(mConfig.baseSeed), static_cast<std::uint32_t>(mConfig.baseSeed >> 32),
+        static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(env.episode) };
+    std::uint32_t seed;
+    sequence.generate(&seed, &seed + 1);
+    env.episode++;
+
+    SimulationConfig config;
+    config.seed = seed;
+    config.tickRate = mConfig.tickRate;
+    config.loadStoredScores = false;
+    config.chunks = mConfig.chunks;
+    env.simulation = std::make_unique<Simulation>(config);
+}
+
+void VecEnv::stepBlock(std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        Simulation& simulation = *mEnvs[i].simulation;
+        const std::uint8_t action = mActions[i];
+        if (action != NOOP && action < ACTION_COUNT) {
+            simulation.perform(static_cast<PlayerAction>(action - 1));
+        }
+        const int coins = simulation.getScore().getCoins();
+        simulation.step();
+
+        float reward;
+        Done done = RUNNING;
+        if (simulation.isOver()) {
+            reward = mConfig.deathReward;
+            done = DIED;
+        }
+        else {
+            reward = simulation.getTickTime().asSeconds() +
+                mConfig.coinReward * static_cast<float>(simulation.getScore().getCoins() - coins);
+            if (simulation.getTickCount() >= mMaxTicks) {
+                done = TIME_LIMIT;
+            }
+        }
+        mRewards[i] = reward;
+        mDones[i] = done;
+        if (done != RUNNING) {
+            startEpisode(i);
+        }
+        writeObservation(*mEnvs[i].simulation, mObservations + i * OBSERVATION_SIZE);
+    }
+}
+
+void VecEnv::resetBlock(std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        startEpisode(i);
+        writeObservation(*mEnvs[i].simulation, mObservations + i * OBSERVATION_SIZE);
+    }
+}
+
+void VecEnv::blockRange(unsigned int block, std::size_t& begin, std::size_t& end) const {
+    begin = mEnvs.size() * block / mThreads;
+    end = mEnvs.size() * (block + 1) / mThreads;
+}
+
+void VecEnv::runJob(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJob = job;
+        mGeneration++;
+        mPending = mThreads - 1;
+    }
+    mStart.notify_all();
+
+    if (job != Job::QUIT) {
+        std::size_t begin;
+        std::size_t end;
+        blockRange(0, begin, end);
+        if (job == Job::STEP) {
+            stepBlock(begin, end);
+        }
+        else {
+            resetBlock(begin, end);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFinished.wait(lock, [this] { return mPending == 0; });
+}
+
+void VecEnv::workerLoop(unsigned int block) {
+    std::size_t begin;
+    std::size_t end;
+    blockRange(block, begin, end);
+    std::uint64_t seen = 0;
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mStart.wait(lock, [&] { return mGeneration != seen; });
+            seen = mGeneration;
+            job = mJob;
+        }
+        if (job == Job::STEP) {
+            stepBlock(begin, end);
+        }
+        else if (job == Job::RESET) {
+            resetBlock(begin, end);
+        }
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            last = --mPending == 0;
+        }
+        if (last) {
+            mFinished.notify_one();
+        }
+        if (job == Job::QUIT) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "ConcreteObstacles.h"
+#include "LaneSystem.h"
+#include "Simulation.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct VecEnvConfig {
+    std::size_t envs = 64;
+    unsigned int threads = 0; // 0 = one per hardware thread, never more than envs
+    std::uint64_t baseSeed = 1;
+    unsigned int tickRate = 60;
+    float maxSeconds = 600.0f; // episodes still alive after this long are cut off
+    float coinReward = 0.1f; // reward per coin, on top of 1 per second survived
+    float deathReward = -1.0f; // reward on the tick the player dies
+    const ChunkLibrary* chunks = nullptr; // authored track chunks for every episode
+};
+
+// N independent headless games stepped together, for training agents:
+// step(actions[N]) -> observations[N], rewards[N], dones[N]. Outputs go
+// straight into caller-owned arrays (observations is one contiguous
+// N * OBSERVATION_SIZE float buffer), so nothing is copied or allocated per
+// step apart from the runs that restart.
+//
+// Environments are split into one contiguous block per thread; the caller's
+// thread steps the first block and persistent workers the others. Each
+// episode's seed comes from baseSeed, the environment index and its episode
+// number, so results do not depend on the thread count.
+//
+// A finished episode restarts inside the same step(): its dones entry says
+// why it ended and its observation is already the new episode's first one.
+class VecEnv {
+public:
+    // Actions, one byte per environment.
+    enum Action : std::uint8_t { NOOP, MOVE_LEFT, MOVE_RIGHT, JUMP, SLIDE, ACTION_COUNT };
+    // dones values.
+    enum Done : std::uint8_t { RUNNING, DIED, TIME_LIMIT };
+
+    // Observation layout. Per lane (left to right) at lane * LANE_FEATURES:
+    //   0     distance to the nearest obstacle still ahead of the player
+    //   1-4   that obstacle's type, one-hot in ObstacleType order
+    //   5     distance to the nearest power-up ahead
+    //   6     distance to the nearest coin ahead
+    // then the player at PLAYER_OFFSET:
+    //   0-2   lane, one-hot
+    //   3-5   running, jumping, sliding, one-hot
+    //   6     height above the ground over JUMP_HEIGHT
+    //   7     track speed over MAX_SPEED
+    //   8-10  shield, magnet, double coins active (0 or 1)
+    // Distances are how far an entity still has to scroll to reach the
+    // player's box, over VIEW_DISTANCE and clamped to [0, 1]; 1 = none in view.
+    static constexpr std::size_t LANE_FEATURES = 3 + ObstacleRegistry::COUNT;
+    static constexpr std::size_t PLAYER_OFFSET = LaneSystem::LANE_COUNT * LANE_FEATURES;
+    static constexpr std::size_t PLAYER_FEATURES = 11;
+    static constexpr std::size_t OBSERVATION_SIZE = PLAYER_OFFSET + PLAYER_FEATURES;
+    static constexpr float VIEW_DISTANCE = 800.0f;
+    static constexpr float JUMP_HEIGHT = 200.0f;
+    static constexpr float MAX_SPEED = 1100.0f;
+
+    explicit VecEnv(const VecEnvConfig& config = VecEnvConfig());
+    ~VecEnv();
+    VecEnv(const VecEnv&) = delete;
+    VecEnv& operator=(const VecEnv&) = delete;
+
+    std::size_t size() const { return mEnvs.size(); }
+    unsigned int getThreadCount() const { return mThreads; }
+
+    // Starts a fresh episode everywhere and writes the first observations.
+    void reset(float* observations);
+
+    // Applies actions[i] to environment i, advances every environment one
+    // tick and writes the results. Out-of-range actions count as NOOP.
+    void step(const std::uint8_t* actions, float* observations, float* rewards, std::uint8_t* dones);
+
+    // The i-th environment's current run, e.g. for rendering one of them.
+    const Simulation& getSimulation(std::size_t i) const { return *mEnvs[i].simulation; }
+
+private:
+    struct Env {
+        std::unique_ptr<Simulation> simulation;
+        std::uint64_t episode = 0;
+    };
+    // What the workers are asked to do with their block.
+    enum class Job { STEP, RESET, QUIT };
+
+    void startEpisode(std::size_t index);
+    void stepBlock(std::size_t begin, std::size_t end);
+    void resetBlock(std::size_t begin, std::size_t end);
+    void runJob(Job job);
+    void workerLoop(unsigned int block);
+    void blockRange(unsigned int block, std::size_t& begin, std::size_t& end) const;
+
+    VecEnvConfig mConfig;
+    std::uint64_t mMaxTicks;
+    std::vector<Env> mEnvs;
+    unsigned int mThreads; // blocks, including the caller's
+
+    // The current call's buffers, read by the workers
+    const std::uint8_t* mActions = nullptr;
+    float* mObservations = nullptr;
+    float* mRewards = nullptr;
+    std::uint8_t* mDones = nullptr;
+
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mStart;
+    std::condition_variable mFinished;
+    Job mJob = Job::STEP;
+    std::uint64_t mGeneration = 0; // bumped for every job
+    unsigned int mPending = 0; // workers still busy with it
+};
+
+// Writes one OBSERVATION_SIZE observation of 'simulation' to 'out'.
+void writeObservation(const Simulation& simulation, float* out);
@@ -0,0 +1,121 @@
+#include "WorldRenderer.h"
+#include "ResourceManager.h"
+#include <string>
+
+namespace {
+    struct SpriteInfo {
+        const char* texture;
+        const char* fallbackTexture;
+        sf::Color color;
+    };
+
+    // Indexed by SpriteId
+    const SpriteInfo kSprites[] = {
+        { "trainFull", "train", sf::Color::White },
+        { "barrier", nullptr, sf::Color::White },
+        { "cone", nullptr, sf::Color::White },
+        { "fence", nullptr, sf::Color::White },
+        { "magnet", nullptr, sf::Color::Red },
+        { "jetpack", nullptr, sf::Color::Cyan },
+        { "shield", nullptr, sf::Color::Blue },
+        { "doublecoin", nullptr, sf::Color::Green },
+    };
+
+    // Longer than the small-string buffer, so built once rather than per lookup
+    const std::string kPlayerTexture("playerSpritesheet");
+
+    const sf::Texture* findTexture(const std::string& name) {
+        auto& rm = ResourceManager::get();
+        return rm.hasTexture(name) ? &rm.getTexture(name) : nullptr;
+    }
+
+    const sf::Texture* findTexture(const SpriteInfo& sprite) {
+        if (const sf::Texture* texture = findTexture(sprite.texture)) {
+            return texture;
+        }
+        return sprite.fallbackTexture ? findTexture(sprite.fallbackTexture) : nullptr;
+    }
+}
+
+WorldRenderer::WorldRenderer() {
+    mCoin.setRadius(CoinStore::RADIUS);
+    mCoin.setOrigin(sf::Vector2f(CoinStore::RADIUS, CoinStore::RADIUS));
+    mCoin.setFillColor(sf::Color::White);
+}
+
+void WorldRenderer::draw(sf::RenderWindow& window, const Simulation& simulation, float alpha) {
+    // The track is drawn this far behind the last tick's scroll
+    const EntityWorld& world = simulation.getTrack().getWorld();
+    const float lag = (1.0f - alpha) * world.getLastAdvance();
+
+    drawCoins(window, world.getCoins(), lag);
+    drawObstacles(window, world.getObstacles(), lag);
+    drawPowerUps(window, world.getPowerUps(), lag);
+    drawPlayer(window, simulation.getPlayer(), alpha);
+}
+
+void WorldRenderer::drawCoins(sf::RenderWindow& window, const CoinStore& coins, float lag) {
+    // Textures may be (re)loaded after the renderer was created, so look it up per frame.
+    mCoin.setTexture(findTexture("coin"));
+    for (std::size_t i = 0; i < coins.size(); ++i) {
+        if (!coins.isAlive(i)) {
+            continue;
+        }
+        const sf::Vector2f position = coins.getPosition(i);
+        mCoin.setPosition(sf::Vector2f(position.x, position.y - lag));
+        mCoin.setRotation(coins.getRotation(i));
+        window.draw(mCoin);
+    }
+}
+
+void WorldRenderer::drawObstacles(sf::RenderWindow& window, const EntityWorld::ObstacleTable& obstacles, float lag) {
+    const Position* positions = obstacles.column<Position>();
+    const Velocity* velocities = obstacles.column<Velocity>();
+    const Extent* extents = obstacles.column<Extent>();
+    const Render* renders = obstacles.column<Render>();
+    const Status* status = obstacles.column<Status>();
+    for (size_t i = 0; i < obstacles.size(); ++i) {
+        if (status[i].dead) {
+            continue;
+        }
+        const Extent& e = extents[i];
+        const SpriteInfo& sprite = kSprites[static_cast<int>(renders[i].sprite)];
+        mBox.setSize(sf::Vector2f(e.right - e.left, e.bottom - e.top));
+        mBox.setPosition(sf::Vector2f(positions[i].x + e.left, positions[i].y - velocities[i].scroll * lag + e.top));
+        mBox.setFillColor(sprite.color);
+        mBox.setTexture(findTexture(sprite), true);
+        window.draw(mBox);
+    }
+}
+
+void WorldRenderer::drawPowerUps(sf::RenderWindow& window, const EntityWorld::PowerUpTable& powerUps, float lag) {
+    const Position* positions = powerUps.column<Position>();
+    const Velocity* velocities = powerUps.column<Velocity>();
+    const Extent* extents = powerUps.column<Extent>();
+    const Render* renders = powerUps.column<Render>();
+    const Status* status = powerUps.column<Status>();
+    for (size_t i = 0; i < powerUps.size(); ++i) {
+        if (status[i].dead) {
+            continue;
+        }
+        const float radius = extents[i].right;
+        const SpriteInfo& sprite = kSprites[static_cast<int>(renders[i].sprite)];
+        mCircle.setRadius(radius);
+        mCircle.setOrigin(sf::Vector2f(radius, radius));
+        mCircle.setPosition(sf::Vector2f(positions[i].x, positions[i].y - velocities[i].scroll * lag));
+        mCircle.setRotation(renders[i].rotation);
+        mCircle.setFillColor(sprite.color);
+        mCircle.setTexture(findTexture(sprite), true);
+        window.draw(mCircle);
+    }
+}
+
+void WorldRenderer::drawPlayer(sf::RenderWindow& window, const Player& player, float alpha) {
+    const sf::Vector2f previous = player.getPreviousPosition();
+    const sf::Vector2f size = player.getSize();
+    mPlayerShape.setSize(size);
+    mPlayerShape.setOrigin(sf::Vector2f(size.x / 2.0f, size.y)); // bottom centre
+    mPlayerShape.setPosition(previous + (player.getPosition() - previous) * alpha);
+    mPlayerShape.setTexture(findTexture(kPlayerTexture));
+    window.draw(mPlayerShape);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Simulation.h"
+#include <SFML/Graphics.hpp>
+
+// Draws a Simulation into a window. The simulation core keeps plain data
+// only; the SFML shapes live here and are reused every frame, since building
+// an sf::Shape allocates its vertex array.
+class WorldRenderer {
+public:
+    WorldRenderer();
+
+    // 'alpha' is where the frame lies between the previous tick (0) and the
+    // last one (1); the track and the player are interpolated accordingly.
+    void draw(sf::RenderWindow& window, const Simulation& simulation, float alpha);
+
+private:
+    void drawCoins(sf::RenderWindow& window, const CoinStore& coins, float lag);
+    void drawObstacles(sf::RenderWindow& window, const EntityWorld::ObstacleTable& obstacles, float lag);
+    void drawPowerUps(sf::RenderWindow& window, const EntityWorld::PowerUpTable& powerUps, float lag);
+    void drawPlayer(sf::RenderWindow& window, const Player& player, float alpha);
+
+    sf::RectangleShape mBox;
+    sf::CircleShape mCircle;
+    sf::CircleShape mCoin;
+    sf::RectangleShape mPlayerShape;
+};
@@ -1,8 +1,238 @@
-#include <SFML/Graphics.hpp>
-#include "GameEngine.h"
-
-int main() {
-    GameEngine game;
-    game.run();
-    return 0;
-}
+#include <SFML/Graphics.hpp>
+#include "BatchRunner.h"
+#include "ChunkLibrary.h"
+#include "EntityBenchmark.h"
+#include "GameEngine.h"
+#include "HeadlessRunner.h"
+#include "LeaderboardService.h"
+#include "Spectator.h"
+#include <SFML/System/Clock.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace {
+    // Offline checks that run once every argument is read, so they see
+    // --tick-rate wherever it appears
+    enum class CheckMode { None, Spectator, Rewind, BotSoak, TrackStream };
+
+    // Splits "host:port" (or just "host"); the port falls back to 'defaultPort'.
+    void parseAddress(const std::string& address, std::string& host, unsigned short& port, unsigned short defaultPort) {
+        const std::size_t colon = address.rfind(':');
+        host = address.substr(0, colon);
+        port = colon == std::string::npos
+            ? defaultPort
+            : static_cast<unsigned short>(std::strtoul(address.c_str() + colon + 1, nullptr, 10));
+        if (host.empty()) {
+            host = "localhost";
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    unsigned int tickRate = GameEngine::DEFAULT_TICK_RATE;
+    bool headless = false;
+    unsigned long long headlessTicks = 0;
+    bool batch = false;
+    BatchConfig batchConfig;
+    BatchFormat batchFormat = BatchFormat::JSON;
+    std::string policyName = batchConfig.policyName;
+    GameConfig gameConfig;
+    bool loadTest = false;
+    LeaderboardLoadConfig loadConfig;
+    bool vecEnvBench = false;
+    VecEnvConfig vecEnvConfig;
+    std::filesystem::path replayPath;
+    bool chunksGiven = false; // tools only use a chunk library when asked to
+    CheckMode check = CheckMode::None;
+    unsigned long long checkTicks = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--bench-entities") {
+            std::size_t count = hasValue ? std::strtoul(argv[i + 1], nullptr, 10) : 10000;
+            runEntityBenchmark(count > 0 ? count : 10000, 600, std::cout);
+            return 0;
+        }
+        if (arg == "--chunk-bench") {
+            runChunkBenchmark(std::cout);
+            return 0;
+        }
+        if (arg == "--lane-grid-bench") {
+            runLaneGridBenchmark(std::cout);
+            return 0;
+        }
+        if (arg == "--compile-chunks" && i + 2 < argc) {
+            // Build step for track chunks: --compile-chunks source.txt library.bin
+            return compileChunkLibrary(argv[i + 1], argv[i + 2], std::cout) ? 0 : 1;
+        }
+        if (arg == "--chunks" && hasValue) {
+            gameConfig.chunkPath = argv[++i];
+            chunksGiven = true;
+        }
+        if (arg == "--replay" && hasValue) {
+            replayPath = argv[++i];
+        }
+        if (arg == "--spectator-check" || arg == "--rewind-check" || arg == "--bot-soak" ||
+            arg == "--track-stream-check") {
+            check = arg == "--spectator-check" ? CheckMode::Spectator
+                : arg == "--rewind-check" ? CheckMode::Rewind
+                : arg == "--bot-soak" ? CheckMode::BotSoak
+                : CheckMode::TrackStream;
+            checkTicks = hasValue ? std::strtoull(argv[i + 1], nullptr, 10) : 0;
+        }
+        if (arg == "--practice") {
+            gameConfig.practice = true;
+        }
+        if (arg == "--bot") {
+            gameConfig.autopilot = true;
+        }
+        if (arg == "--spectate" && hasValue) {
+            // Headless subscriber: --spectate host:port [seconds]
+            std::string host;
+            unsigned short port;
+            parseAddress(argv[i + 1], host, port, 0);
+            const float seconds = i + 2 < argc ? std::strtof(argv[i + 2], nullptr) : 0.0f;
+            return runSpectatorClient(host, port, seconds, std::cout) ? 0 : 1;
+        }
+        if (arg == "--leaderboard-daemon") {
+            unsigned long port = hasValue ? std::strtoul(argv[i + 1], nullptr, 10) : 0;
+            return runLeaderboardDaemon(port > 0 ? static_cast<unsigned short>(port) : LeaderboardProtocol::DEFAULT_PORT,
+                std::filesystem::path("data") / "leaderboard.log", std::cout) ? 0 : 1;
+        }
+        if (arg == "--leaderboard" && hasValue) {
+            parseAddress(argv[++i], gameConfig.leaderboardHost, gameConfig.leaderboardPort,
+                LeaderboardProtocol::DEFAULT_PORT);
+        }
+        if (arg == "--leaderboard-load" && hasValue) {
+            // --leaderboard-load host[:port] [submitters]
+            parseAddress(argv[++i], loadConfig.host, loadConfig.port, LeaderboardProtocol::DEFAULT_PORT);
+            std::size_t submitters = i + 1 < argc ? std::strtoul(argv[i + 1], nullptr, 10) : 0;
+            loadConfig.submitters = submitters > 0 ? submitters : loadConfig.submitters;
+            loadTest = true;
+        }
+        if (arg == "--connections" && hasValue) {
+            loadConfig.connections = std::strtoul(argv[++i], nullptr, 10);
+        }
+        if (arg == "--spectate-port" && hasValue) {
+            gameConfig.spectatePort = static_cast<unsigned short>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        if (arg == "--spectate-bind" && hasValue) {
+            // Opt-in to subscribers from other machines, e.g. --spectate-bind 0.0.0.0
+            gameConfig.spectateAddress = sf::IpAddress(argv[++i]);
+        }
+        if (arg == "--record" && hasValue) {
+            gameConfig.recordPath = argv[++i];
+        }
+        if (arg == "--tick-rate" && hasValue) {
+            tickRate = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        if (arg == "--headless") {
+            headlessTicks = hasValue ? std::strtoull(argv[i + 1], nullptr, 10) : 0;
+            headless = true;
+        }
+        if (arg == "--vecenv") {
+            // Training API benchmark: --vecenv [envs], with --threads/--seed
+            std::size_t envs = hasValue ? std::strtoul(argv[i + 1], nullptr, 10) : 0;
+            vecEnvConfig.envs = envs > 0 ? envs : vecEnvConfig.envs;
+            vecEnvBench = true;
+        }
+        if (arg == "--batch") {
+            std::size_t runs = hasValue ? std::strtoul(argv[i + 1], nullptr, 10) : 0;
+            batchConfig.runs = runs > 0 ? runs : batchConfig.runs;
+            batch = true;
+        }
+        if (arg == "--threads" && hasValue) {
+            batchConfig.threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        if (arg == "--seed" && hasValue) {
+            batchConfig.baseSeed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        if (arg == "--max-seconds" && hasValue) {
+            batchConfig.maxSeconds = std::strtof(argv[++i], nullptr);
+        }
+        if (arg == "--policy" && hasValue) {
+            policyName = argv[++i];
+        }
+        if (arg == "--format" && hasValue) {
+            batchFormat = std::string(argv[++i]) == "csv" ? BatchFormat::CSV : BatchFormat::JSON;
+        }
+    }
+
+    checkTicks = checkTicks > 0 ? checkTicks : 36000;
+    switch (check) {
+    case CheckMode::Spectator:
+        return runSpectatorCheck(checkTicks, tickRate, std::cout) ? 0 : 1;
+    case CheckMode::Rewind:
+        return runRewindCheck(checkTicks, tickRate, std::cout) ? 0 : 1;
+    case CheckMode::BotSoak:
+        return runAutopilotSoak(checkTicks, tickRate, std::cout) ? 0 : 1;
+    case CheckMode::TrackStream:
+        return runTrackStreamCheck(checkTicks, tickRate, std::cout) ? 0 : 1;
+    case CheckMode::None:
+        break;
+    }
+
+    // Shared read-only by every run below
+    ChunkLibrary chunks;
+    if (chunksGiven || !replayPath.empty()) {
+        std::error_code ec;
+        const bool needed = chunksGiven || std::filesystem::exists(gameConfig.chunkPath, ec);
+        if (needed && !chunks.load(gameConfig.chunkPath)) {
+            std::cerr << "Could not load chunk library " << gameConfig.chunkPath.string() << "\n";
+            return 1;
+        }
+    }
+    const ChunkLibrary* chunksUsed = chunksGiven ? &chunks : nullptr;
+
+    if (!replayPath.empty()) {
+        // Plays a recorded run back headless, with the game's chunk library
+        // if it was recorded with one; non-zero exit if it diverged
+        return runReplay(replayPath, chunks.isLoaded() ? &chunks : nullptr, std::cout) ? 0 : 1;
+    }
+
+    if (batch) {
+        batchConfig.chunks = chunksUsed;
+        batchConfig.policy = findInputPolicy(policyName);
+        if (!batchConfig.policy) {
+            std::cerr << "Unknown input policy: " << policyName << "\n";
+            return 1;
+        }
+        batchConfig.policyName = policyName.c_str();
+        batchConfig.tickRate = tickRate > 0 ? tickRate : GameEngine::DEFAULT_TICK_RATE;
+
+        // Data goes to stdout, timing to stderr
+        sf::Clock clock;
+        std::vector<RunResult> results = runBatch(batchConfig);
+        const float seconds = clock.getElapsedTime().asSeconds();
+        writeBatchReport(batchConfig, results, batchFormat, std::cout);
+        std::cerr << results.size() << " runs in " << seconds << " s\n";
+        return 0;
+    }
+
+    if (loadTest) {
+        loadConfig.threads = batchConfig.threads;
+        return runLeaderboardLoadTest(loadConfig, std::cout) ? 0 : 1;
+    }
+
+    if (vecEnvBench) {
+        vecEnvConfig.threads = batchConfig.threads;
+        vecEnvConfig.chunks = chunksUsed;
+        vecEnvConfig.baseSeed = batchConfig.baseSeed;
+        vecEnvConfig.tickRate = tickRate > 0 ? tickRate : GameEngine::DEFAULT_TICK_RATE;
+        return runVecEnvBenchmark(vecEnvConfig, 6000, std::cout) ? 0 : 1;
+    }
+
+    if (headless) {
+        // No window, no assets: just the simulation core
+        runHeadless(headlessTicks > 0 ? headlessTicks : 36000, tickRate, chunksUsed, std::cout,
+            gameConfig.recordPath);
+        return 0;
+    }
+
+    gameConfig.tickRate = tickRate;
+    GameEngine game(gameConfig);
+    game.run();
+    return 0;
+}